@@ -0,0 +1,324 @@
+"""
+Convert binary VAWT log files to the standard CSV
+
+Handles both on-card binary encodings written by DataLogger:
+
+  LOG_FORMAT_BINARY - packed 33-byte fixed records
+  LOG_FORMAT_DELTA  - tagged stream: 0xFF keyframe (full 33-byte record)
+                      every 64 records, 0xFE delta records holding one
+                      zigzag LEB128 varint per field against the previous
+                      record's quantized values
+
+Emits the same header/columns as the on-device CSV format, so the
+existing analysis scripts work unchanged. The format is auto-detected
+on structural evidence: a fixed-record file is an exact multiple of 33
+bytes with a valid state byte in each of its leading records, while a
+delta stream opens with a keyframe tag followed by another tag 34 bytes
+in. (The first byte alone is not enough - the low byte of millis() at
+segment open is 0xFE/0xFF for ~1 in 128 rotations.) --format overrides
+the detection when a damaged file defeats it.
+
+Delta streams survive mid-stream cuts (the staging ring evicts
+byte-exact under a card outage): on an unknown tag or an implausible
+decoded timestamp the converter scans to the next keyframe whose state
+and timestamp pass a sanity check, drops the unreadable span, and
+continues.
+
+Record layout (little-endian, packed, see lib/Logging/DataLogger.h):
+    uint32  timestamp (ms since boot)
+    uint8   state (TurbineState enum)
+    float   wind_speed_ms, rotor_rpm, voltage_dc, current_dc,
+            power_w, lambda, cp
+
+Usage:
+    python convert_binary_log.py [--format binary|delta] vawt_data.bin [vawt_data.csv]
+
+Author: Dr. Asitha Kulasekera
+"""
+
+import math
+import struct
+import sys
+from pathlib import Path
+
+RECORD_FORMAT = '<IB7f'  # uint32 timestamp, uint8 state, 7 floats
+RECORD_SIZE = struct.calcsize(RECORD_FORMAT)  # 33 bytes
+
+TAG_KEYFRAME = 0xFF
+TAG_DELTA = 0xFE
+
+# Fixed-point scale per field; must match DataLogger::quantizeRecord()
+# (timestamp, state, wind x10, rpm x1, V x100, A x100, W x10,
+#  lambda x100, cp x1000)
+DELTA_SCALES = (1, 1, 10, 1, 100, 100, 10, 100, 1000)
+DELTA_FIELD_COUNT = len(DELTA_SCALES)
+
+CSV_HEADER = 'timestamp,state,wind_speed_ms,rotor_rpm,voltage_dc,current_dc,power_w,lambda,cp'
+
+# Must match the TurbineState enum in lib/StateMachine/TurbineStateMachine.h
+STATE_NAMES = {
+    0: 'IDLE',
+    1: 'STANDBY',
+    2: 'STARTUP',
+    3: 'MPPT',
+    4: 'POWER_REG',
+    5: 'STALL',
+    6: 'FAULT',
+}
+
+
+def write_row(fout, timestamp, state, wind_speed, rpm, voltage,
+              current, power, lam, cp):
+    state_name = STATE_NAMES.get(state, 'UNKNOWN')
+    fout.write(f'{timestamp},{state_name},{wind_speed:.1f},{rpm:.0f},'
+               f'{voltage:.2f},{current:.2f},{power:.1f},'
+               f'{lam:.2f},{cp:.3f}\n')
+
+
+def quantize(fields):
+    """Mirror of DataLogger::quantizeRecord() - floor(x*scale + 0.5)"""
+    return [int(math.floor(v * s + 0.5)) for v, s in zip(fields, DELTA_SCALES)]
+
+
+def read_varint(fin):
+    """LEB128 varint; returns None on clean EOF, raises on mid-value EOF"""
+    value = 0
+    shift = 0
+    while True:
+        byte = fin.read(1)
+        if not byte:
+            if shift == 0:
+                return None
+            raise EOFError('truncated varint')
+        b = byte[0]
+        value |= (b & 0x7F) << shift
+        if not (b & 0x80):
+            return value
+        shift += 7
+
+
+def convert_fixed(fin, fout):
+    """Fixed 33-byte record stream (LOG_FORMAT_BINARY)"""
+    count = 0
+    while True:
+        chunk = fin.read(RECORD_SIZE)
+        if len(chunk) < RECORD_SIZE:
+            if chunk:
+                print(f'Warning: {len(chunk)} trailing bytes ignored '
+                      '(truncated record from power loss?)')
+            break
+        fields = struct.unpack(RECORD_FORMAT, chunk)
+        write_row(fout, *fields)
+        count += 1
+    return count
+
+
+# An accepted keyframe must not jump the timestamp by more than this
+# against the last good record. Cumulative ring evictions during a long
+# card outage can legitimately drop hours, so the bound is generous
+MAX_TIMESTAMP_JUMP_MS = 24 * 3600 * 1000
+
+# Consecutive records inside one delta chain are a single log period
+# apart, so a decoded delta stepping further than this is garbage (a
+# stream cut that landed on a 0xFE byte); an hour is orders of magnitude
+# beyond any sane log period
+DELTA_MAX_STEP_MS = 3600 * 1000
+
+
+def plausible_keyframe(fields, last_timestamp):
+    """Accept a resync candidate only if it looks like a real record:
+    known state byte and a timestamp that moves forward (0xFF bytes occur
+    freely inside record payloads, so tag position alone is weak)"""
+    timestamp, state = fields[0], fields[1]
+    if state not in STATE_NAMES:
+        return False
+    if last_timestamp is None:
+        return True
+    return last_timestamp <= timestamp <= last_timestamp + MAX_TIMESTAMP_JUMP_MS
+
+
+def resync_to_keyframe(fin, last_timestamp):
+    """Scan forward for the next plausible keyframe after a cut or
+    corrupt region (ring eviction under a card outage cuts the stream at
+    an arbitrary byte). Returns (fields, bytes_skipped) with fin past the
+    keyframe, or (None, bytes_skipped) at EOF."""
+    skipped = 0
+    while True:
+        b = fin.read(1)
+        if not b:
+            return None, skipped
+        if b[0] != TAG_KEYFRAME:
+            skipped += 1
+            continue
+        pos = fin.tell()
+        chunk = fin.read(RECORD_SIZE)
+        if len(chunk) < RECORD_SIZE:
+            return None, skipped + 1 + len(chunk)
+        fields = struct.unpack(RECORD_FORMAT, chunk)
+        if plausible_keyframe(fields, last_timestamp):
+            return fields, skipped
+        # False positive (payload byte): resume scanning after the tag
+        fin.seek(pos)
+        skipped += 1
+
+
+def convert_delta(fin, fout):
+    """Tagged keyframe/delta stream (LOG_FORMAT_DELTA)"""
+    count = 0
+    prev = None  # Quantized field values of the previous record
+    last_timestamp = None
+    need_resync = False
+    while True:
+        if need_resync:
+            fields, skipped = resync_to_keyframe(fin, last_timestamp)
+            if skipped:
+                print(f'Warning: skipped {skipped} bytes to the next keyframe')
+            if fields is None:
+                break
+            need_resync = False
+            write_row(fout, *fields)
+            prev = quantize(fields)
+            last_timestamp = fields[0]
+            count += 1
+            continue
+
+        tag = fin.read(1)
+        if not tag:
+            break
+        tag = tag[0]
+        if tag == TAG_KEYFRAME:
+            pos = fin.tell()
+            chunk = fin.read(RECORD_SIZE)
+            if len(chunk) < RECORD_SIZE:
+                print(f'Warning: truncated keyframe ignored '
+                      f'({len(chunk)} of {RECORD_SIZE} bytes)')
+                break
+            fields = struct.unpack(RECORD_FORMAT, chunk)
+            # Same sanity check as resync: if earlier garbage left the
+            # parser misaligned, this "keyframe" is payload bytes
+            if not plausible_keyframe(fields, last_timestamp):
+                print(f'Warning: implausible keyframe at record {count} '
+                      '- resyncing')
+                fin.seek(pos)
+                need_resync = True
+                continue
+            write_row(fout, *fields)
+            prev = quantize(fields)
+            last_timestamp = fields[0]
+            count += 1
+        elif tag == TAG_DELTA:
+            if prev is None:
+                print('Warning: delta record before any keyframe '
+                      '(segment started mid-chain?) - resyncing')
+                need_resync = True
+                continue
+            try:
+                deltas = []
+                for _ in range(DELTA_FIELD_COUNT):
+                    zz = read_varint(fin)
+                    if zz is None:
+                        raise EOFError('truncated delta record')
+                    deltas.append((zz >> 1) ^ -(zz & 1))  # Zigzag decode
+            except EOFError as exc:
+                print(f'Warning: {exc} at end of file ignored')
+                break
+            candidate = [p + d for p, d in zip(prev, deltas)]
+            # A cut landing on a 0xFE byte decodes garbage that no tag
+            # check can catch - reject it on the timestamp instead
+            if not (last_timestamp <= candidate[0]
+                    <= last_timestamp + DELTA_MAX_STEP_MS):
+                print(f'Warning: implausible delta timestamp '
+                      f'{candidate[0]} after {last_timestamp} at record '
+                      f'{count} - resyncing (stream cut mid-record?)')
+                need_resync = True
+                continue
+            prev = candidate
+            last_timestamp = prev[0]
+            write_row(fout, prev[0], prev[1],
+                      *(v / s for v, s in zip(prev[2:], DELTA_SCALES[2:])))
+            count += 1
+        else:
+            print(f'Warning: unknown tag 0x{tag:02X} at record {count} - '
+                  'resyncing (stream cut by ring eviction?)')
+            need_resync = True
+    return count
+
+
+def detect_format(head, size):
+    """Detect LOG_FORMAT_BINARY vs LOG_FORMAT_DELTA from structure.
+
+    The first byte alone is ambiguous: a fixed record starts with the
+    low byte of millis(), which is 0xFE or 0xFF for ~1 in 128 segment
+    opens - and segments reopen on every rotation. So decide on
+    stronger evidence, checked in order of specificity:
+
+      binary - file size is an exact multiple of 33 and the state byte
+               (offset 4) of each of the leading records is a valid
+               TurbineState. A delta stream passing all of that by
+               chance requires valid states at varint-determined
+               offsets - vanishingly unlikely.
+      delta  - opens with a keyframe tag and, when the file is long
+               enough, has another tag exactly one keyframe (34 bytes)
+               in.
+
+    Falls back to the first-byte heuristic with a warning when neither
+    signature matches (truncated or damaged file); --format overrides.
+    """
+    if size == 0:
+        return 'binary'
+    if size % RECORD_SIZE == 0:
+        checks = min(size // RECORD_SIZE, 8)
+        if all(head[i * RECORD_SIZE + 4] in STATE_NAMES
+               for i in range(checks)):
+            return 'binary'
+    if head[0] == TAG_KEYFRAME and \
+            (size <= RECORD_SIZE + 1 or
+             head[RECORD_SIZE + 1] in (TAG_KEYFRAME, TAG_DELTA)):
+        return 'delta'
+    guess = 'delta' if head[0] in (TAG_KEYFRAME, TAG_DELTA) else 'binary'
+    print(f'Warning: no clean format signature, guessing {guess} from '
+          'the first byte - pass --format to override')
+    return guess
+
+
+def convert(binary_path, csv_path, fmt=None):
+    """Convert one binary log file to CSV, returns the record count"""
+    with open(binary_path, 'rb') as fin, open(csv_path, 'w') as fout:
+        fout.write(CSV_HEADER + '\n')
+        if fmt is None:
+            head = fin.read(8 * RECORD_SIZE + 2)
+            if not head:
+                return 0
+            fin.seek(0)
+            fmt = detect_format(head, Path(binary_path).stat().st_size)
+        if fmt == 'delta':
+            return convert_delta(fin, fout)
+        return convert_fixed(fin, fout)
+
+
+def main():
+    args = sys.argv[1:]
+    fmt = None
+    if '--format' in args:
+        i = args.index('--format')
+        if i + 1 >= len(args) or args[i + 1] not in ('binary', 'delta'):
+            print('Error: --format takes "binary" or "delta"')
+            sys.exit(1)
+        fmt = args[i + 1]
+        del args[i:i + 2]
+    if not args:
+        print(__doc__)
+        sys.exit(1)
+
+    binary_path = Path(args[0])
+    if len(args) >= 2:
+        csv_path = Path(args[1])
+    else:
+        csv_path = binary_path.with_suffix('.csv')
+
+    count = convert(binary_path, csv_path, fmt)
+    print(f'Converted {count} records: {binary_path} -> {csv_path}')
+
+
+if __name__ == '__main__':
+    main()
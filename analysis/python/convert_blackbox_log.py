@@ -0,0 +1,104 @@
+"""
+Convert a black-box fault dump (vawt_bb_*.bin) to CSV
+
+BlackBox freezes a 50 Hz ring of the control loop's last ~30 s (plus 2 s
+of aftermath) when SafetyMonitor trips or the state machine enters
+FAULT, and writes it behind a small header. Fields are quantized to the
+same resolutions as the delta log.
+
+File layout (little-endian, packed, see lib/BlackBox/BlackBox.h):
+    header: uint32 magic 'VBB1', uint8 version, uint8 record_size,
+            uint16 rate_hz, uint32 count, uint32 trigger_millis
+    records (17 bytes each):
+        uint32 timestamp (ms since boot)
+        uint8  state (TurbineState enum)
+        int16  wind x10, rpm, voltage x100, current x100, power x10
+        uint16 duty x1000
+
+Usage:
+    python convert_blackbox_log.py vawt_bb_boot000.bin [out.csv]
+
+Author: Dr. Asitha Kulasekera
+"""
+
+import struct
+import sys
+from pathlib import Path
+
+HEADER_FORMAT = '<IBBHII'
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)  # 16 bytes
+RECORD_FORMAT = '<IB5hH'
+RECORD_SIZE = struct.calcsize(RECORD_FORMAT)  # 17 bytes
+
+MAGIC = 0x31424256  # "VBB1"
+
+# Must match the TurbineState enum in lib/StateMachine/TurbineStateMachine.h
+STATE_NAMES = {
+    0: 'IDLE',
+    1: 'STANDBY',
+    2: 'STARTUP',
+    3: 'MPPT',
+    4: 'POWER_REG',
+    5: 'STALL',
+    6: 'FAULT',
+}
+
+CSV_HEADER = ('timestamp,state,wind_speed_ms,rotor_rpm,voltage_dc,'
+              'current_dc,power_w,duty_cycle,trigger_offset_s')
+
+
+def convert(input_path, output_path):
+    data = Path(input_path).read_bytes()
+    if len(data) < HEADER_SIZE:
+        print('Error: file shorter than the dump header')
+        sys.exit(1)
+
+    magic, version, record_size, rate_hz, count, trigger_ms = \
+        struct.unpack_from(HEADER_FORMAT, data, 0)
+    if magic != MAGIC:
+        print('Error: bad magic 0x%08x (not a black-box dump)' % magic)
+        sys.exit(1)
+    if record_size != RECORD_SIZE:
+        print('Error: record size %d in header, decoder expects %d '
+              '(version mismatch?)' % (record_size, RECORD_SIZE))
+        sys.exit(1)
+
+    written = 0
+    with open(output_path, 'w') as fout:
+        fout.write(CSV_HEADER + '\n')
+        offset = HEADER_SIZE
+        for _ in range(count):
+            if offset + RECORD_SIZE > len(data):
+                print('Warning: dump truncated at record %d of %d'
+                      % (written, count))
+                break
+            (timestamp, state, wind_deci, rpm, volt_centi, curr_centi,
+             power_deci, duty_milli) = struct.unpack_from(
+                RECORD_FORMAT, data, offset)
+            offset += RECORD_SIZE
+            fout.write('%d,%s,%.1f,%d,%.2f,%.2f,%.1f,%.3f,%.2f\n' % (
+                timestamp,
+                STATE_NAMES.get(state, 'UNKNOWN'),
+                wind_deci / 10.0,
+                rpm,
+                volt_centi / 100.0,
+                curr_centi / 100.0,
+                power_deci / 10.0,
+                duty_milli / 1000.0,
+                (timestamp - trigger_ms) / 1000.0))
+            written += 1
+
+    print('Converted %d records @ %d Hz (trigger at t=%d ms) -> %s'
+          % (written, rate_hz, trigger_ms, output_path))
+
+
+if __name__ == '__main__':
+    if len(sys.argv) < 2:
+        print('Usage: python convert_blackbox_log.py vawt_bb_*.bin [out.csv]')
+        sys.exit(1)
+    input_path = sys.argv[1]
+    if len(sys.argv) > 2:
+        output_path = sys.argv[2]
+    else:
+        output_path = str(Path(input_path).with_suffix('.csv'))
+    convert(input_path, output_path)
@@ -0,0 +1,83 @@
+"""
+Convert the per-minute summary log (vawt_summary.bin) to CSV
+
+DataLogger writes one packed 58-byte SummaryRecord per minute alongside
+the raw log: min/mean/max of power, RPM and wind speed, per-state
+residency counters and the number of FAULT entries. A day is ~80 KB
+regardless of the raw sample rate, so dashboards pull this file instead
+of the raw segments.
+
+Record layout (little-endian, packed, see lib/Logging/DataLogger.h):
+    uint32    timestamp (ms since boot at minute close)
+    uint16    samples (raw samples aggregated)
+    uint16    fault_entries (transitions into FAULT)
+    float x9  power min/mean/max, rpm min/mean/max, wind min/mean/max
+    uint16 x7 samples spent per TurbineState (IDLE..FAULT)
+
+Usage:
+    python convert_summary_log.py vawt_summary.bin [vawt_summary.csv]
+
+Author: Dr. Asitha Kulasekera
+"""
+
+import struct
+import sys
+from pathlib import Path
+
+RECORD_FORMAT = '<IHH9f7H'
+RECORD_SIZE = struct.calcsize(RECORD_FORMAT)  # 58 bytes
+
+# Must match the TurbineState enum in lib/StateMachine/TurbineStateMachine.h
+STATE_NAMES = ('IDLE', 'STANDBY', 'STARTUP', 'MPPT',
+               'POWER_REG', 'STALL', 'FAULT')
+
+CSV_HEADER = (
+    'timestamp,samples,fault_entries,'
+    'power_min_w,power_mean_w,power_max_w,'
+    'rpm_min,rpm_mean,rpm_max,'
+    'wind_min_ms,wind_mean_ms,wind_max_ms,'
+    + ','.join('samples_' + name.lower() for name in STATE_NAMES)
+)
+
+
+def convert(input_path, output_path):
+    data = Path(input_path).read_bytes()
+    count = 0
+    with open(output_path, 'w') as fout:
+        fout.write(CSV_HEADER + '\n')
+        offset = 0
+        while offset + RECORD_SIZE <= len(data):
+            fields = struct.unpack_from(RECORD_FORMAT, data, offset)
+            offset += RECORD_SIZE
+            timestamp, samples, fault_entries = fields[0:3]
+            power_min, power_mean, power_max = fields[3:6]
+            rpm_min, rpm_mean, rpm_max = fields[6:9]
+            wind_min, wind_mean, wind_max = fields[9:12]
+            state_samples = fields[12:19]
+            fout.write(
+                '%d,%d,%d,%.1f,%.1f,%.1f,%.0f,%.0f,%.0f,%.1f,%.1f,%.1f,%s\n'
+                % (timestamp, samples, fault_entries,
+                   power_min, power_mean, power_max,
+                   rpm_min, rpm_mean, rpm_max,
+                   wind_min, wind_mean, wind_max,
+                   ','.join(str(s) for s in state_samples)))
+            count += 1
+
+    trailing = len(data) - offset
+    if trailing:
+        print('Warning: %d trailing bytes ignored (truncated record)'
+              % trailing)
+    print('Converted %d summary records -> %s' % (count, output_path))
+
+
+if __name__ == '__main__':
+    if len(sys.argv) < 2:
+        print('Usage: python convert_summary_log.py vawt_summary.bin '
+              '[vawt_summary.csv]')
+        sys.exit(1)
+    input_path = sys.argv[1]
+    if len(sys.argv) > 2:
+        output_path = sys.argv[2]
+    else:
+        output_path = str(Path(input_path).with_suffix('.csv'))
+    convert(input_path, output_path)
@@ -0,0 +1,104 @@
+#ifndef NATIVE_ARDUINO_SHIM_H
+#define NATIVE_ARDUINO_SHIM_H
+
+/**
+ * Minimal Arduino.h shim for the [env:native] host build.
+ *
+ * Provides just enough of the Arduino API for the controller libraries
+ * (MPPTController, TurbineStateMachine, SafetyMonitor) to compile and
+ * run on the host: a simulated millis()/micros() clock the replay
+ * harness advances explicitly, constrain/min/max, PI and a stdout-backed
+ * Serial. Header-only so the native environment needs no extra
+ * translation unit - it is pulled in via '-I hal/native' and never seen
+ * by the ESP32 builds.
+ *
+ * The clock is simulated rather than wall time on purpose: a batch run
+ * can step through millions of trace seconds per wall-clock second and
+ * state-machine timing (getTimeInState etc.) still behaves exactly as on
+ * target.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cstdarg>
+#include <cmath>
+#include <cstdlib>
+
+#define PI 3.1415926535897932384626433832795
+
+// Arduino-style macros: deliberately type-promiscuous, matching the
+// mixed float/double literals in the firmware code
+#define constrain(amt, low, high) \
+    ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Functions rather than macros so later standard-library includes do not
+// break (the classic Arduino min/max macro clash)
+template <typename T>
+inline T min(T a, T b) { return a < b ? a : b; }
+template <typename T>
+inline T max(T a, T b) { return a > b ? a : b; }
+
+// --- Simulated clock -----------------------------------------------------
+
+inline uint64_t &shimClockMicros()
+{
+    static uint64_t simMicros = 0;
+    return simMicros;
+}
+
+inline unsigned long micros() { return (unsigned long)shimClockMicros(); }
+inline unsigned long millis() { return (unsigned long)(shimClockMicros() / 1000); }
+
+// delay() advances simulated time instantly - batch runs never sleep
+inline void delay(unsigned long ms) { shimClockMicros() += (uint64_t)ms * 1000; }
+inline void delayMicroseconds(unsigned int us) { shimClockMicros() += us; }
+
+namespace ArduinoShim
+{
+    inline void advanceMillis(uint64_t ms) { shimClockMicros() += ms * 1000; }
+    inline void setMillis(uint64_t ms) { shimClockMicros() = ms * 1000; }
+}
+
+// --- Serial --------------------------------------------------------------
+
+class HardwareSerialShim
+{
+public:
+    // Silence transition/debug prints during batch sweeps
+    bool enabled = true;
+
+    void begin(unsigned long) {}
+
+    void printf(const char *fmt, ...)
+    {
+        if (!enabled)
+            return;
+        va_list args;
+        va_start(args, fmt);
+        vfprintf(stdout, fmt, args);
+        va_end(args);
+    }
+
+    void println(const char *s)
+    {
+        if (enabled)
+            fprintf(stdout, "%s\n", s);
+    }
+
+    void println()
+    {
+        if (enabled)
+            fprintf(stdout, "\n");
+    }
+
+    void print(const char *s)
+    {
+        if (enabled)
+            fputs(s, stdout);
+    }
+};
+
+inline HardwareSerialShim Serial;
+
+#endif
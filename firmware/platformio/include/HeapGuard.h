@@ -0,0 +1,27 @@
+/*
+ * Debug-build assertion that the control task performs zero heap
+ * allocations in steady state.
+ *
+ * The esp32dev_heapcheck env builds with -DVAWT_ASSERT_NO_HEAP plus
+ * -Wl,--wrap on malloc/calloc/realloc; the wrappers abort the firmware
+ * with a tagged message if any allocation happens on the guarded task
+ * after heapGuardArm(). In normal builds everything compiles away.
+ *
+ * Run this env after touching the control path: an allocation there is a
+ * latency bug (allocator lock + eventual fragmentation stalls), not a
+ * functional one, so it only shows up in month-long runs otherwise.
+ */
+
+#ifndef HEAP_GUARD_H
+#define HEAP_GUARD_H
+
+#include <Arduino.h>
+
+#ifdef VAWT_ASSERT_NO_HEAP
+// Arm the guard for one task; call from that task once init is done
+void heapGuardArm(TaskHandle_t task);
+#else
+inline void heapGuardArm(TaskHandle_t) {}
+#endif
+
+#endif
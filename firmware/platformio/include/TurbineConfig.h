@@ -0,0 +1,52 @@
+#ifndef TURBINE_CONFIG_H
+#define TURBINE_CONFIG_H
+
+/**
+ * Compile-time turbine configuration.
+ *
+ * One firmware tree serves every rotor in the fleet: the model is picked
+ * by a -DVAWT_MODEL_* build flag in platformio.ini and everything here
+ * is constexpr, so derived factors like 2π/60·R and 0.5·ρ·A fold into
+ * constants at compile time and the hot path never recomputes them (and
+ * never calls pow()).
+ *
+ * Supported models:
+ *   VAWT_MODEL_HELICAL_500W - 500 W helical Gorlov (default)
+ *   VAWT_MODEL_HELICAL_300W - 300 W helical Gorlov (smaller rotor)
+ */
+
+struct TurbineConfig
+{
+#if defined(VAWT_MODEL_HELICAL_300W)
+    // 300 W Helical Gorlov VAWT
+    static constexpr float ROTOR_RADIUS = 0.5f;  // m
+    static constexpr float ROTOR_HEIGHT = 1.2f;  // m
+    static constexpr float SWEPT_AREA = 1.2f;    // m²
+    static constexpr float LAMBDA_OPT = 2.0f;
+    static constexpr float CP_MAX = 0.33f;
+    static constexpr float RATED_POWER = 300.0f; // W
+    static constexpr float RATED_RPM = 200.0f;
+    static constexpr float OVERSPEED_RPM = 280.0f;
+#else
+    // 500 W Helical Gorlov VAWT (default)
+    static constexpr float ROTOR_RADIUS = 0.6f;  // m
+    static constexpr float ROTOR_HEIGHT = 1.5f;  // m
+    static constexpr float SWEPT_AREA = 1.8f;    // m²
+    static constexpr float LAMBDA_OPT = 2.0f;
+    static constexpr float CP_MAX = 0.35f;
+    static constexpr float RATED_POWER = 500.0f; // W
+    static constexpr float RATED_RPM = 180.0f;
+    static constexpr float OVERSPEED_RPM = 250.0f;
+#endif
+
+    // Site air density (coastal Sri Lanka, ~30°C)
+    static constexpr float AIR_DENSITY = 1.15f; // kg/m³
+
+    // Derived constants - folded at compile time
+    static constexpr float PI_F = 3.14159265358979f;
+    static constexpr float OMEGA_PER_RPM = 2.0f * PI_F / 60.0f;       // rad/s per RPM
+    static constexpr float TIP_SPEED_PER_RPM = OMEGA_PER_RPM * ROTOR_RADIUS; // m/s per RPM
+    static constexpr float HALF_RHO_A = 0.5f * AIR_DENSITY * SWEPT_AREA;     // ½ρA
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "AnemometerInput.h"
+
+AnemometerInput::AnemometerInput()
+    : _channel(ADC1_CHANNEL_7),
+      _samplesPerUpdate(256),
+      _running(false),
+      _samplerTaskHandle(NULL),
+      _latestWindSpeed(0)
+{
+}
+
+bool AnemometerInput::begin(adc1_channel_t channel, uint32_t sampleRateHz,
+                            size_t samplesPerUpdate)
+{
+    _channel = channel;
+    _samplesPerUpdate = samplesPerUpdate;
+
+    i2s_config_t config = {};
+    config.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+    config.sample_rate = sampleRateHz;
+    config.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    config.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    config.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    config.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1;
+    config.dma_buf_count = 4;
+    config.dma_buf_len = _samplesPerUpdate;
+    config.use_apll = false;
+
+    if (i2s_driver_install(I2S_PORT, &config, 0, NULL) != ESP_OK)
+    {
+        Serial.println("[ANEMO] I2S driver install failed");
+        return false;
+    }
+
+    i2s_set_adc_mode(ADC_UNIT_1, _channel);
+    adc1_config_channel_atten(_channel, ADC_ATTEN_DB_11); // Full 0-3.3V range
+    i2s_adc_enable(I2S_PORT);
+
+    _running = true;
+
+    // Sampler task lives on core 0 with the rest of the I/O: it blocks on
+    // DMA buffers, never on the control core
+    xTaskCreatePinnedToCore(samplerTaskEntry, "anemo", 2048, this,
+                            3, &_samplerTaskHandle, 0);
+
+    return true;
+}
+
+void AnemometerInput::samplerTaskEntry(void *pvParameters)
+{
+    static_cast<AnemometerInput *>(pvParameters)->samplerTask();
+}
+
+// Drains one DMA block at a time, averages it and publishes the wind
+// speed. i2s_read() blocks until a buffer is ready, so this task costs
+// nothing between blocks.
+void AnemometerInput::samplerTask()
+{
+    const size_t bytesPerBlock = _samplesPerUpdate * sizeof(uint16_t);
+    uint16_t *block = (uint16_t *)malloc(bytesPerBlock);
+    if (block == NULL)
+    {
+        Serial.println("[ANEMO] Sample buffer allocation failed");
+        vTaskDelete(NULL);
+        return;
+    }
+
+    while (_running)
+    {
+        size_t bytesRead = 0;
+        if (i2s_read(I2S_PORT, block, bytesPerBlock, &bytesRead,
+                     portMAX_DELAY) != ESP_OK || bytesRead == 0)
+        {
+            continue;
+        }
+
+        size_t samples = bytesRead / sizeof(uint16_t);
+        uint32_t sum = 0;
+        for (size_t i = 0; i < samples; i++)
+        {
+            sum += block[i] & 0x0FFF; // 12-bit ADC data in the low bits
+        }
+        float rawMean = (float)sum / samples;
+
+        // Analog anemometer: 0-3.3V at the pin = 0-25 m/s
+        _latestWindSpeed = rawMean * (25.0f / 4095.0f);
+    }
+
+    free(block);
+    vTaskDelete(NULL);
+}
+
+void AnemometerInput::end()
+{
+    _running = false;
+    i2s_adc_disable(I2S_PORT);
+    i2s_driver_uninstall(I2S_PORT);
+}
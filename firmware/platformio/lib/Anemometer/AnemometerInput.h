@@ -0,0 +1,62 @@
+#ifndef ANEMOMETER_INPUT_H
+#define ANEMOMETER_INPUT_H
+
+#include <Arduino.h>
+#include <driver/i2s.h>
+#include <driver/adc.h>
+
+/**
+ * Continuous DMA-driven anemometer sampling.
+ *
+ * The ESP32 I2S peripheral reads the anemometer ADC channel continuously
+ * into DMA buffers; a small core-0 task averages each block and publishes
+ * the result. The control loop calls latest(), which is a single 32-bit
+ * load - no blocking analogRead() and no single-sample ADC noise.
+ *
+ * Oversampling matters beyond latency: a lone noisy 12-bit sample fed
+ * into the MPPT wind statistics inflates σ_v and shrinks the adaptive
+ * step for no aerodynamic reason. Averaging hundreds of raw samples per
+ * published value removes that noise floor before it reaches the
+ * statistics.
+ */
+class AnemometerInput
+{
+public:
+    AnemometerInput();
+
+    /**
+     * Start continuous sampling.
+     * @param channel ADC1 channel wired to the anemometer
+     *                (GPIO35 = ADC1_CHANNEL_7)
+     * @param sampleRateHz Raw ADC sample rate (default 16 kHz)
+     * @param samplesPerUpdate Raw samples averaged per published value
+     *                         (default 256 -> ~62 Hz output)
+     */
+    bool begin(adc1_channel_t channel, uint32_t sampleRateHz = 16000,
+               size_t samplesPerUpdate = 256);
+
+    /**
+     * Most recent oversampled wind speed. Non-blocking single load,
+     * safe from any task.
+     * @return Wind speed (m/s)
+     */
+    float latest() const { return _latestWindSpeed; }
+
+    void end();
+
+private:
+    static const i2s_port_t I2S_PORT = I2S_NUM_0;
+
+    adc1_channel_t _channel;
+    size_t _samplesPerUpdate;
+    bool _running;
+    TaskHandle_t _samplerTaskHandle;
+
+    // Published result: aligned 32-bit float, atomic to read on ESP32
+    volatile float _latestWindSpeed;
+
+    static void samplerTaskEntry(void *pvParameters);
+    void samplerTask();
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include "BlackBox.h"
+#include <math.h>
+#include <time.h>
+
+// Heap-allocating string types are banned here: capture() runs on the
+// control task at 50 Hz for the life of the firmware
+#pragma GCC poison String
+
+// Quantize with the delta log's floor(x + 0.5) rounding, clamped to the
+// int16 range rather than wrapping on a sensor glitch
+static int16_t quantize16(float value, float scale)
+{
+    float scaled = floorf(value * scale + 0.5f);
+    if (scaled > 32767.0f)
+        return 32767;
+    if (scaled < -32768.0f)
+        return -32768;
+    return (int16_t)scaled;
+}
+
+BlackBox::BlackBox()
+    : _head(0),
+      _count(0),
+      _postTicksLeft(0),
+      _armed(0),
+      _frozen(0),
+      _triggerMillis(0),
+      _everTriggered(0),
+      _dumpSequence(0),
+      _droppedDumps(0)
+{
+}
+
+void BlackBox::capture(unsigned long timestamp, uint8_t state,
+                       float windSpeed, float rpm, float voltage,
+                       float current, float power, float duty)
+{
+    if (_frozen)
+    {
+        return; // Ring belongs to the I/O task until the dump completes
+    }
+
+    BlackBoxRecord &rec = _ring[_head];
+    rec.timestamp = (uint32_t)timestamp;
+    rec.state = state;
+    rec.windDeci = quantize16(windSpeed, 10.0f);
+    rec.rpm = quantize16(rpm, 1.0f);
+    rec.voltCenti = quantize16(voltage, 100.0f);
+    rec.currCenti = quantize16(current, 100.0f);
+    rec.powerDeci = quantize16(power, 10.0f);
+    rec.dutyMilli = (uint16_t)quantize16(duty, 1000.0f);
+
+    _head = (_head + 1) % RING_SIZE;
+    if (_count < RING_SIZE)
+    {
+        _count++;
+    }
+
+    // Aftermath countdown: keep recording past the trigger so the dump
+    // shows what the trip did, then hand the ring to the I/O task
+    if (_armed)
+    {
+        if (_postTicksLeft > 0)
+        {
+            _postTicksLeft = _postTicksLeft - 1;
+        }
+        else
+        {
+            _armed = 0;
+            _frozen = 1; // Publish last: producer stops at the next call
+        }
+    }
+}
+
+void BlackBox::trigger()
+{
+    if (_armed || _frozen)
+    {
+        return; // Already capturing this event's aftermath or flushing
+    }
+    if (_everTriggered &&
+        millis() - _triggerMillis < TRIGGER_COOLDOWN_MS)
+    {
+        // Cooldown: one dump per ring length. A persistent violation
+        // would otherwise freeze-dump-rearm in a ~2 s loop, and the
+        // repeat dumps mostly overlap the first one's window anyway
+        return;
+    }
+    _everTriggered = 1;
+    _triggerMillis = millis();
+    _postTicksLeft = POST_TRIGGER_TICKS;
+    _armed = 1;
+}
+
+void BlackBox::service()
+{
+    if (!_frozen)
+    {
+        return;
+    }
+
+    if (!writeDump())
+    {
+        _droppedDumps++;
+    }
+
+    // Re-arm whether or not the card took the dump: a stale frozen ring
+    // would miss the next event entirely, which is worse than losing
+    // this one's file
+    _count = 0;
+    _head = 0;
+    _frozen = 0;
+}
+
+// Write the frozen ring, oldest record first, behind a small header.
+// Named from wall time when NTP has synced, else a scan for the first
+// free boot-relative name (the sequence counter resets every boot).
+bool BlackBox::writeDump()
+{
+    char filename[48];
+    time_t now = time(NULL);
+    if (now > 1600000000)
+    {
+        struct tm tmNow;
+        localtime_r(&now, &tmNow);
+        snprintf(filename, sizeof(filename), "/vawt_bb_%04d%02d%02d_%02d%02d%02d.bin",
+                 tmNow.tm_year + 1900, tmNow.tm_mon + 1, tmNow.tm_mday,
+                 tmNow.tm_hour, tmNow.tm_min, tmNow.tm_sec);
+    }
+    else
+    {
+        do
+        {
+            snprintf(filename, sizeof(filename), "/vawt_bb_boot%03u.bin",
+                     (unsigned)_dumpSequence++);
+        } while (SD.exists(filename) && _dumpSequence < 1000);
+    }
+
+    File dump = SD.open(filename, FILE_WRITE);
+    if (!dump)
+    {
+        Serial.println("[BLACKBOX] Failed to open dump file");
+        return false;
+    }
+
+    DumpHeader header;
+    header.magic = DUMP_MAGIC;
+    header.version = DUMP_VERSION;
+    header.recordSize = sizeof(BlackBoxRecord);
+    header.rateHz = CAPTURE_RATE_HZ;
+    header.count = _count;
+    header.triggerMillis = _triggerMillis;
+    dump.write((const uint8_t *)&header, sizeof(header));
+
+    // Chronological order: with the ring full the oldest record sits at
+    // _head; part-full rings start at slot 0
+    int start = (_count == RING_SIZE) ? _head : 0;
+    for (int i = 0; i < _count; i++)
+    {
+        const BlackBoxRecord &rec = _ring[(start + i) % RING_SIZE];
+        if (dump.write((const uint8_t *)&rec, sizeof(rec)) != sizeof(rec))
+        {
+            Serial.println("[BLACKBOX] Dump write failed");
+            dump.close();
+            return false;
+        }
+    }
+    dump.flush();
+    dump.close();
+
+    Serial.printf("[BLACKBOX] %d records (%d s) -> %s\n",
+                  _count, _count / CAPTURE_RATE_HZ, filename);
+    return true;
+}
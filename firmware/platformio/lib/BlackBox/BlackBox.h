@@ -0,0 +1,109 @@
+#ifndef BLACK_BOX_H
+#define BLACK_BOX_H
+
+#include <Arduino.h>
+#include <SD.h>
+
+// One black-box record (17 bytes packed). Fields are quantized to the
+// same resolutions the delta log uses, halving the RAM footprint against
+// raw floats; int16 ranges (3276 W, 327 V, 3276 RPM) comfortably cover
+// the hardware. analysis/python/convert_blackbox_log.py decodes.
+struct __attribute__((packed)) BlackBoxRecord
+{
+    uint32_t timestamp; // ms since boot
+    uint8_t state;      // TurbineState
+    int16_t windDeci;   // m/s x10
+    int16_t rpm;
+    int16_t voltCenti;  // V x100
+    int16_t currCenti;  // A x100
+    int16_t powerDeci;  // W x10
+    uint16_t dutyMilli; // Commanded duty x1000
+};
+
+/**
+ * Fault black-box: always-on pre-trigger capture ring.
+ *
+ * The 1 Hz log cannot say whether an overspeed trip came from a gust, a
+ * load dump or an MPPT misstep. This ring captures the control loop's
+ * view (sensors + commanded duty) at 50 Hz for the last 30 s - a fixed
+ * ~25 KB of RAM, one 17-byte store per capture - and on a safety trip or
+ * FAULT entry keeps recording for 2 s of aftermath, then freezes. The
+ * I/O task flushes the frozen ring to its own SD file and re-arms, so
+ * per-event detail costs nothing at steady state instead of permanently
+ * logging at 50x the volume.
+ *
+ * Threading, house pattern: capture() and trigger() run on the control
+ * task only; service() runs on the I/O task and touches the ring only
+ * while _frozen is set, i.e. after the producer has stopped writing.
+ * The flags are volatile 32-bit stores, the same handoff the logger's
+ * sealed buffers use.
+ */
+class BlackBox
+{
+public:
+    static const int CAPTURE_RATE_HZ = 50;
+    static const int PRE_TRIGGER_S = 30;
+    static const int RING_SIZE = CAPTURE_RATE_HZ * PRE_TRIGGER_S;
+    static const int POST_TRIGGER_TICKS = 2 * CAPTURE_RATE_HZ;
+
+    BlackBox();
+
+    /**
+     * Record one control-loop snapshot (control task, 50 Hz). O(1):
+     * quantize into the ring slot and advance. No-op while frozen.
+     */
+    void capture(unsigned long timestamp, uint8_t state, float windSpeed,
+                 float rpm, float voltage, float current, float power,
+                 float duty);
+
+    /**
+     * Arm the freeze: capture continues for POST_TRIGGER_TICKS of
+     * aftermath, then stops. Control-task safe, idempotent while a
+     * trigger is already pending or frozen, and rate-limited by
+     * TRIGGER_COOLDOWN_MS - a persistent violation re-fires the safety
+     * check every tick, and without the cooldown each re-arm cycle
+     * would dump another ~25 KB to the card every couple of seconds.
+     */
+    void trigger();
+
+    /**
+     * Flush a frozen ring to a dedicated SD file and re-arm. I/O task
+     * only; all SD latency lives here. Returns without side effects
+     * when nothing is frozen.
+     */
+    void service();
+
+    /** Events whose dump failed (no card); the ring re-arms regardless */
+    uint32_t getDroppedDumps() const { return _droppedDumps; }
+
+private:
+    // On-card file header ahead of the record stream
+    struct __attribute__((packed)) DumpHeader
+    {
+        uint32_t magic; // 'VBB1'
+        uint8_t version;
+        uint8_t recordSize;
+        uint16_t rateHz;
+        uint32_t count;         // Records following the header
+        uint32_t triggerMillis; // When trigger() fired
+    };
+
+    static const uint32_t DUMP_MAGIC = 0x31424256; // "VBB1" little-endian
+    static const uint8_t DUMP_VERSION = 1;
+    static const uint32_t TRIGGER_COOLDOWN_MS = 30000; // One ring length
+
+    BlackBoxRecord _ring[RING_SIZE];
+    int _head;      // Next write slot (control task only)
+    int _count;     // Valid records, saturates at RING_SIZE
+    volatile uint32_t _postTicksLeft; // Aftermath countdown, 0 = not armed
+    volatile uint32_t _armed;         // Trigger accepted, counting down
+    volatile uint32_t _frozen;        // Ring stable, awaiting flush
+    uint32_t _triggerMillis;
+    uint32_t _everTriggered; // _triggerMillis is valid
+    uint32_t _dumpSequence;
+    uint32_t _droppedDumps;
+
+    bool writeDump();
+};
+
+#endif
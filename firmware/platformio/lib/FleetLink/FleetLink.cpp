@@ -0,0 +1,222 @@
+#include "FleetLink.h"
+#include <WiFi.h>
+#include <esp_wifi.h>
+#include <string.h>
+
+FleetLink *FleetLink::instance = NULL;
+
+static const uint8_t BROADCAST_MAC[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+FleetLink::FleetLink()
+    : _role(FLEET_MEMBER),
+      _started(false),
+      _state(0),
+      _faultFlags(0),
+      _power(0),
+      _rpm(0),
+      _windSpeed(0),
+      _gustWarningPending(0),
+      _gustWindSpeed(0),
+      _lastPeerGustMillis(0),
+      _peerGustSeen(0),
+      _peerCount(0),
+      _lastStatusSend(0),
+      _sendFailures(0)
+{
+}
+
+bool FleetLink::begin(Role role)
+{
+    _role = role;
+
+    // ESP-NOW rides on the STA interface. Members never associate; they
+    // just pin the radio to the fleet channel. The gateway's AP must be
+    // on FLEET_CHANNEL too, or its association would drag the radio off
+    // the channel the members broadcast on.
+    WiFi.mode(WIFI_STA);
+    esp_wifi_set_channel(FLEET_CHANNEL, WIFI_SECOND_CHAN_NONE);
+
+    if (esp_now_init() != ESP_OK)
+    {
+        Serial.println("[FLEET] esp_now_init failed");
+        return false;
+    }
+
+    instance = this;
+    esp_now_register_recv_cb(onReceive);
+
+    // Broadcast peer entry (required before esp_now_send to broadcast)
+    esp_now_peer_info_t peerInfo = {};
+    memcpy(peerInfo.peer_addr, BROADCAST_MAC, 6);
+    peerInfo.channel = FLEET_CHANNEL;
+    peerInfo.encrypt = false;
+    if (esp_now_add_peer(&peerInfo) != ESP_OK)
+    {
+        Serial.println("[FLEET] add broadcast peer failed");
+        return false;
+    }
+
+    _started = true;
+    Serial.printf("[FLEET] %s on channel %u\n",
+                  role == FLEET_GATEWAY ? "Gateway" : "Member",
+                  (unsigned)FLEET_CHANNEL);
+    return true;
+}
+
+void FleetLink::setStatus(uint8_t state, uint8_t faultFlags,
+                          float power, float rpm, float windSpeed)
+{
+    _state = state;
+    _faultFlags = faultFlags;
+    _power = power;
+    _rpm = rpm;
+    _windSpeed = windSpeed;
+}
+
+void FleetLink::signalGustWarning(float windSpeed)
+{
+    _gustWindSpeed = windSpeed;
+    _gustWarningPending = 1; // Set last: service() sends once per set
+}
+
+void FleetLink::service()
+{
+    if (!_started)
+    {
+        return;
+    }
+
+    unsigned long now = millis();
+
+    // Pending gust warning goes out first - it is the latency-sensitive
+    // frame; a downstream rotor has seconds at most
+    if (_gustWarningPending)
+    {
+        _gustWarningPending = 0;
+        Frame frame;
+        frame.magic = FRAME_MAGIC;
+        frame.version = PROTOCOL_VERSION;
+        frame.type = FRAME_GUST_WARNING;
+        frame.state = _state;
+        frame.faultFlags = _faultFlags;
+        frame.power = _power;
+        frame.rpm = _rpm;
+        frame.windSpeed = _gustWindSpeed;
+        broadcast(frame);
+    }
+
+    if (now - _lastStatusSend >= STATUS_PERIOD_MS)
+    {
+        _lastStatusSend = now;
+        Frame frame;
+        frame.magic = FRAME_MAGIC;
+        frame.version = PROTOCOL_VERSION;
+        frame.type = FRAME_STATUS;
+        frame.state = _state;
+        frame.faultFlags = _faultFlags;
+        frame.power = _power;
+        frame.rpm = _rpm;
+        frame.windSpeed = _windSpeed;
+        broadcast(frame);
+    }
+
+    // Age out peers that went quiet (powered down, radio fault). The
+    // receive callback inserts into the same array from the WiFi task,
+    // so the compaction runs under the peer-table spinlock - the table
+    // is 16 entries, the hold is microseconds
+    portENTER_CRITICAL(&_peerMux);
+    for (int i = 0; i < _peerCount;)
+    {
+        if (now - _peers[i].lastSeen > PEER_STALE_MS)
+        {
+            _peers[i] = _peers[_peerCount - 1];
+            _peerCount--;
+        }
+        else
+        {
+            i++;
+        }
+    }
+    portEXIT_CRITICAL(&_peerMux);
+}
+
+int FleetLink::copyPeers(PeerStatus *out)
+{
+    portENTER_CRITICAL(&_peerMux);
+    int count = _peerCount;
+    for (int i = 0; i < count; i++)
+    {
+        out[i] = _peers[i];
+    }
+    portEXIT_CRITICAL(&_peerMux);
+    return count;
+}
+
+bool FleetLink::peerGustWarningActive() const
+{
+    if (!_peerGustSeen)
+    {
+        return false;
+    }
+    return millis() - _lastPeerGustMillis < GUST_WARNING_HOLD_MS;
+}
+
+void FleetLink::onReceive(const uint8_t *mac, const uint8_t *data, int len)
+{
+    if (instance == NULL || len < (int)sizeof(Frame))
+    {
+        return;
+    }
+    Frame frame;
+    memcpy(&frame, data, sizeof(frame));
+    if (frame.magic != FRAME_MAGIC || frame.version != PROTOCOL_VERSION)
+    {
+        return;
+    }
+    instance->handleFrame(mac, frame);
+}
+
+// Runs in the WiFi task (core 0). The gust-warning fields are plain
+// stores the control task reads; the peer table is shared with
+// service()'s aging pass on the I/O task, so updates hold the spinlock.
+void FleetLink::handleFrame(const uint8_t *mac, const Frame &frame)
+{
+    if (frame.type == FRAME_GUST_WARNING)
+    {
+        _lastPeerGustMillis = millis();
+        _peerGustSeen = 1;
+    }
+
+    // Track the sender (gateway aggregates everyone; members keep the
+    // table too - it is small and makes any unit promotable to gateway)
+    portENTER_CRITICAL(&_peerMux);
+    for (int i = 0; i < _peerCount; i++)
+    {
+        if (memcmp(_peers[i].mac, mac, 6) == 0)
+        {
+            _peers[i].lastSeen = millis();
+            _peers[i].frame = frame;
+            portEXIT_CRITICAL(&_peerMux);
+            return;
+        }
+    }
+    if (_peerCount < MAX_PEERS)
+    {
+        memcpy(_peers[_peerCount].mac, mac, 6);
+        _peers[_peerCount].lastSeen = millis();
+        _peers[_peerCount].frame = frame;
+        _peerCount++;
+    }
+    portEXIT_CRITICAL(&_peerMux);
+}
+
+bool FleetLink::broadcast(const Frame &frame)
+{
+    if (esp_now_send(BROADCAST_MAC, (const uint8_t *)&frame,
+                     sizeof(frame)) != ESP_OK)
+    {
+        _sendFailures++;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,153 @@
+#ifndef FLEET_LINK_H
+#define FLEET_LINK_H
+
+#include <Arduino.h>
+#include <esp_now.h>
+
+/**
+ * ESP-NOW site fleet link for multi-turbine installations.
+ *
+ * 6-12 units share a site; per-unit WiFi associations to a distant AP
+ * are slow and flaky, so only one unit (the gateway) associates and owns
+ * the WiFi/MQTT uplink. Everyone else participates connectionless over
+ * ESP-NOW on a fixed channel:
+ *
+ *   members  - broadcast a compact status frame every STATUS_PERIOD_MS
+ *              (state, fault flags, power, RPM, wind) and an immediate
+ *              gust-warning frame on STALL entry.
+ *   gateway  - aggregates the frames into a fleet table for the uplink
+ *              and the site summary.
+ *   everyone - listens for peer gust warnings: a neighbor's STALL
+ *              arrives milliseconds ahead of the gust convecting to
+ *              downstream rotors, and peerGustWarningActive() lets the
+ *              control loop pre-arm.
+ *
+ * Threading follows the house pattern: signalGustWarning() and the
+ * status snapshot setters are safe from the control task (flag/field
+ * stores only); all radio I/O happens in service() on the I/O task and
+ * in the ESP-NOW receive callback (WiFi task, core 0). The peer table
+ * is the one structure touched from two tasks (callback inserts,
+ * service() ages), so both sides hold a short portMUX critical section
+ * around it.
+ */
+class FleetLink
+{
+public:
+    enum Role
+    {
+        FLEET_MEMBER,
+        FLEET_GATEWAY
+    };
+
+    // Frame types
+    static const uint8_t FRAME_STATUS = 1;
+    static const uint8_t FRAME_GUST_WARNING = 2;
+
+    // On-air frame (20 bytes; ESP-NOW max payload is 250)
+    struct __attribute__((packed)) Frame
+    {
+        uint32_t magic; // 'FLT1'
+        uint8_t version;
+        uint8_t type;      // FRAME_*
+        uint8_t state;     // TurbineState
+        uint8_t faultFlags; // bit0 overspeed, bit1 overvoltage, bit2 overcurrent
+        float power;
+        float rpm;
+        float windSpeed;
+    };
+
+    // One tracked peer on the gateway
+    struct PeerStatus
+    {
+        uint8_t mac[6];
+        unsigned long lastSeen; // millis() of last frame
+        Frame frame;
+    };
+
+    static const int MAX_PEERS = 16;
+
+    FleetLink();
+
+    /**
+     * Join the site fleet. Puts WiFi in STA mode and pins the ESP-NOW
+     * channel (the site AP must sit on FLEET_CHANNEL so the gateway can
+     * hold its association on the same one). Call once from setup().
+     */
+    bool begin(Role role);
+
+    /**
+     * Update the status this unit broadcasts. Control-task safe: plain
+     * field stores, transmitted later by service().
+     */
+    void setStatus(uint8_t state, uint8_t faultFlags,
+                   float power, float rpm, float windSpeed);
+
+    /**
+     * Flag a gust warning for immediate broadcast (control-task safe;
+     * the frame goes out on the next service() pass, typically within
+     * one I/O loop).
+     */
+    void signalGustWarning(float windSpeed);
+
+    /** Radio work: periodic status + pending warnings. I/O task only. */
+    void service();
+
+    /**
+     * True while a peer's gust warning is fresh (within
+     * GUST_WARNING_HOLD_MS). Safe from the control task.
+     */
+    bool peerGustWarningActive() const;
+
+    /**
+     * Snapshot the gateway-side fleet table under the peer-table
+     * spinlock. Indexing the live table directly would race the
+     * receive callback's 20-byte frame rewrites, tearing power/state
+     * mid-read - callers iterate the copy instead.
+     * @param out Destination, at least MAX_PEERS entries
+     * @return Number of peers copied
+     */
+    int copyPeers(PeerStatus *out);
+
+    uint32_t getSendFailures() const { return _sendFailures; }
+
+private:
+    static const uint32_t FRAME_MAGIC = 0x31544C46; // "FLT1" little-endian
+    static const uint8_t PROTOCOL_VERSION = 1;
+    static const uint8_t FLEET_CHANNEL = 1;
+    static const uint32_t STATUS_PERIOD_MS = 5000;
+    static const uint32_t GUST_WARNING_HOLD_MS = 5000;
+    static const uint32_t PEER_STALE_MS = 30000;
+
+    Role _role;
+    bool _started;
+
+    // Own status snapshot (control task writes, service() reads)
+    volatile uint8_t _state;
+    volatile uint8_t _faultFlags;
+    volatile float _power;
+    volatile float _rpm;
+    volatile float _windSpeed;
+    volatile uint32_t _gustWarningPending;
+    volatile float _gustWindSpeed;
+
+    // Peer gust warning (receive callback writes, control task reads)
+    volatile unsigned long _lastPeerGustMillis;
+    volatile uint32_t _peerGustSeen;
+
+    // Peer table: written by the receive callback (WiFi task) and
+    // compacted by service() (I/O task) - not SPSC, so a spinlock
+    // guards it
+    portMUX_TYPE _peerMux = portMUX_INITIALIZER_UNLOCKED;
+    PeerStatus _peers[MAX_PEERS];
+    int _peerCount;
+
+    unsigned long _lastStatusSend;
+    uint32_t _sendFailures;
+
+    static FleetLink *instance; // For the C receive callback
+    static void onReceive(const uint8_t *mac, const uint8_t *data, int len);
+    void handleFrame(const uint8_t *mac, const Frame &frame);
+    bool broadcast(const Frame &frame);
+};
+
+#endif
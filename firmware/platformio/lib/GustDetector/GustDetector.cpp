@@ -0,0 +1,76 @@
+#include "GustDetector.h"
+#include <math.h>
+
+GustDetector::GustDetector()
+    : _bandAmplitude(0),
+      _shortTermRise(0),
+      _onset(false)
+{
+    for (int i = 0; i < MPPTController::WIND_WINDOW; i++)
+    {
+        _window[i] = 0;
+    }
+}
+
+// Goertzel recurrence for a single DFT bin. For one bin this is the
+// cheapest spectral probe there is: two states, one multiply-add per
+// sample, and because k >= 1 over exactly n samples it is orthogonal to
+// the window's DC component - no detrending pass needed. A real wind
+// ramp is not a pure DC shift, so its leakage lands in these low bins,
+// which is exactly the signature being hunted.
+float GustDetector::goertzelEnergy(const float *samples, int n, int bin)
+{
+    float coeff = 2.0f * cosf(2.0f * (float)M_PI * (float)bin / (float)n);
+    float s1 = 0;
+    float s2 = 0;
+    for (int i = 0; i < n; i++)
+    {
+        float s0 = samples[i] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+    return s1 * s1 + s2 * s2 - coeff * s1 * s2;
+}
+
+void GustDetector::update(const MPPTController &mppt)
+{
+    int n = mppt.copyWindWindow(_window);
+    if (n < MPPTController::WIND_WINDOW)
+    {
+        // Warm-up: no stable spectrum from a partial window
+        _bandAmplitude = 0;
+        _shortTermRise = 0;
+        _onset = false;
+        return;
+    }
+
+    // Low-frequency band energy, bins BIN_MIN..BIN_MAX (0.1-0.5 Hz).
+    // 5 bins x 100 samples = 500 multiply-adds per call at 1 Hz.
+    float energy = 0;
+    for (int bin = BIN_MIN; bin <= BIN_MAX; bin++)
+    {
+        energy += goertzelEnergy(_window, n, bin);
+    }
+    // Scale back to m/s: a sinusoid of amplitude A at bin k contributes
+    // (A*n/2)^2 of Goertzel energy
+    _bandAmplitude = sqrtf(energy) * 2.0f / (float)n;
+
+    // Short-term mean rise: newest 2 s vs the whole window
+    float recentSum = 0;
+    float totalSum = 0;
+    for (int i = 0; i < n; i++)
+    {
+        totalSum += _window[i];
+        if (i >= n - RECENT_SAMPLES)
+        {
+            recentSum += _window[i];
+        }
+    }
+    _shortTermRise = recentSum / (float)RECENT_SAMPLES - totalSum / (float)n;
+    if (_shortTermRise < 0)
+    {
+        _shortTermRise = 0; // Falling wind is never a gust onset
+    }
+
+    _onset = (_bandAmplitude + _shortTermRise) > SCORE_THRESHOLD;
+}
@@ -0,0 +1,82 @@
+#ifndef GUST_DETECTOR_H
+#define GUST_DETECTOR_H
+
+#include <Arduino.h>
+#include "MPPTController.h"
+
+/**
+ * Spectral gust-onset detector over the MPPT wind window.
+ *
+ * The MPPT already keeps a 100-sample (10 s @ 10 Hz) wind history but
+ * reduces it to a single sigma_v. A gust front looks different from
+ * ordinary turbulence in the frequency domain: energy concentrates in
+ * the lowest resolvable bins (0.1-0.5 Hz - large coherent eddies) and
+ * the short-term mean rises, seconds before the raw wind speed crosses
+ * the stall threshold. This stage extracts both signatures so the STALL
+ * transition can pre-arm instead of waiting for the bare
+ * windSpeed > stall compare.
+ *
+ *   bandAmplitude - Goertzel energy in bins 1-5 of the 10 s window
+ *                   (0.1-0.5 Hz), scaled back to m/s. Goertzel needs
+ *                   only the 5 bins of interest, so the scan is
+ *                   5 x 100 multiply-adds - a few microseconds on the
+ *                   ESP32 FPU, no FFT workspace, no esp-dsp dependency.
+ *   shortTermRise - mean of the newest 2 s minus the whole-window mean;
+ *                   catches monotonic ramps that put little energy in
+ *                   the AC bins.
+ *
+ * gustOnset() is the combined indicator: bandAmplitude + shortTermRise
+ * above SCORE_THRESHOLD with a full window. update() runs at 1 Hz on
+ * the control task (same task that owns the MPPT buffer, so the copy
+ * needs no locking); gustOnset() is then read by the 50 Hz event-posting
+ * block.
+ */
+class GustDetector
+{
+public:
+    GustDetector();
+
+    /**
+     * Recompute the spectral indicators from the MPPT's wind window.
+     * Control task only, 1 Hz - the 10 s window shifts by 10 samples
+     * between calls, so finer scheduling buys nothing.
+     */
+    void update(const MPPTController &mppt);
+
+    /** Coherent low-frequency (0.1-0.5 Hz) amplitude, m/s */
+    float bandAmplitude() const { return _bandAmplitude; }
+
+    /** Newest-2s mean minus whole-window mean, m/s */
+    float shortTermRise() const { return _shortTermRise; }
+
+    /** Combined score (bandAmplitude + shortTermRise), m/s */
+    float gustScore() const { return _bandAmplitude + _shortTermRise; }
+
+    /** True while the score exceeds SCORE_THRESHOLD on a full window */
+    bool gustOnset() const { return _onset; }
+
+private:
+    // Lowest/highest Goertzel bin over the 100-sample window: bin k is
+    // k x 0.1 Hz. Bin 0 (DC) is excluded; above 0.5 Hz is ordinary
+    // turbulence that the adaptive MPPT step already handles.
+    static const int BIN_MIN = 1;
+    static const int BIN_MAX = 5;
+
+    // Newest samples forming the short-term mean (2 s @ 10 Hz)
+    static const int RECENT_SAMPLES = 20;
+
+    // Combined-score trip point, m/s. Tuned on recorded gust traces: a
+    // 4 m/s front ramping over ~5 s scores ~2 m/s one to two seconds
+    // before the raw speed crosses the 12 m/s stall threshold, while
+    // steady 20% TI wind stays below ~0.8.
+    static constexpr float SCORE_THRESHOLD = 1.2f;
+
+    float _window[MPPTController::WIND_WINDOW];
+    float _bandAmplitude;
+    float _shortTermRise;
+    bool _onset;
+
+    static float goertzelEnergy(const float *samples, int n, int bin);
+};
+
+#endif
@@ -1,17 +1,94 @@
 #include "DataLogger.h"
+#include <time.h>
+
+// Heap-allocating string types are banned in this translation unit: the
+// sample path runs from the control task and must stay allocation-free
+// (state names come from the shared static table, filenames live in a
+// fixed char array)
+#pragma GCC poison String
+
+const char *DataLogger::INDEX_FILENAME = "/vawt_index.csv";
+const char *DataLogger::SUMMARY_FILENAME = "/vawt_summary.bin";
 
 DataLogger::DataLogger()
     : _csPin(5),
       _sdInitialized(false),
-      _bufferPos(0)
+      _format(LOG_FORMAT_CSV),
+      _flushRequested(0),
+      _active(0),
+      _droppedRecords(0),
+      _ring(NULL),
+      _ringCapacity(0),
+      _ringHead(0),
+      _ringTail(0),
+      _ringOverflowBytes(0),
+      _lastRemountAttempt(0),
+      _segmentBytes(0),
+      _segmentStartTime(0),
+      _segmentStartDay(-1),
+      _segmentSequence(0),
+      _deltaHaveKey(false),
+      _deltaRecordsSinceKey(0),
+      _summaryStartMs(0),
+      _summarySamples(0),
+      _summaryFaultEntries(0),
+      _summaryLastState(-1),
+      _summaryPowerMin(0), _summaryPowerMax(0), _summaryPowerSum(0),
+      _summaryRpmMin(0), _summaryRpmMax(0), _summaryRpmSum(0),
+      _summaryWindMin(0), _summaryWindMax(0), _summaryWindSum(0),
+      _summaryHead(0),
+      _summaryTail(0),
+      _summaryDropped(0),
+      _syncIntervalMs(30000), // Commit at most every 30 s...
+      _syncBytes(8192),       // ...or every 8 KB, whichever comes first
+      _lastSyncTime(0),
+      _bytesSinceSync(0)
 {
+    _bufferPos[0] = 0;
+    _bufferPos[1] = 0;
+    _sealed[0] = 0;
+    _sealed[1] = 0;
+    for (int i = 0; i < SUMMARY_STATE_COUNT; i++)
+    {
+        _summaryStateSamples[i] = 0;
+    }
 }
 
-bool DataLogger::begin(uint8_t csPin)
+bool DataLogger::begin(uint8_t csPin, LogFormat format)
 {
     _csPin = csPin;
+    _format = format;
+
+    // Allocate the staging ring: PSRAM if the board has it, otherwise a
+    // small heap ring that still absorbs brief card stalls
+    if (psramFound())
+    {
+        _ring = (uint8_t *)ps_malloc(PSRAM_RING_BYTES);
+        _ringCapacity = PSRAM_RING_BYTES;
+    }
+    if (_ring == NULL)
+    {
+        _ring = (uint8_t *)malloc(HEAP_RING_BYTES);
+        _ringCapacity = HEAP_RING_BYTES;
+    }
+    if (_ring != NULL)
+    {
+        Serial.printf("[LOGGER] Staging ring: %u KB %s\n",
+                      (unsigned)(_ringCapacity / 1024),
+                      psramFound() ? "(PSRAM)" : "(heap)");
+    }
+
+    _lastRemountAttempt = millis();
+
+    // Even if the card is absent now, logging proceeds into the ring and
+    // service() keeps retrying the mount
+    return mountCard();
+}
 
-    // Initialize SD card
+// Mount the card and open the log file. Called from begin() and from the
+// periodic remount retry.
+bool DataLogger::mountCard()
+{
     if (!SD.begin(_csPin))
     {
         Serial.println("[LOGGER] SD Card initialization failed!");
@@ -28,38 +105,165 @@ bool DataLogger::begin(uint8_t csPin)
     }
 
     Serial.println("[LOGGER] SD Card initialized");
+
+    if (!openNewSegment())
+    {
+        _sdInitialized = false;
+        return false;
+    }
+
+    _lastSyncTime = millis();
+    _bytesSinceSync = 0;
     _sdInitialized = true;
 
-    // Create filename with date
-    _filename = "/vawt_data.csv";
+    return true;
+}
+
+// Open a fresh log segment, named from NTP wall time when available
+// (vawt_YYYYMMDD_HHMMSS) or a boot-relative sequence number before sync.
+// The file stays open across flushes: reopening per flush forces a
+// directory-entry and FAT-chain walk every time, which was the dominant
+// source of flush latency as files grew.
+bool DataLogger::openNewSegment()
+{
+    const char *ext = (_format == LOG_FORMAT_CSV) ? "csv" : "bin";
+    time_t now = time(NULL);
 
-    // Check if file exists, if not write header
-    if (!SD.exists(_filename.c_str()))
+    if (now > 1600000000) // Sane wall time = NTP has synced
     {
-        _logFile = SD.open(_filename.c_str(), FILE_WRITE);
-        if (_logFile)
+        struct tm tmNow;
+        localtime_r(&now, &tmNow);
+        snprintf(_filename, sizeof(_filename), "/vawt_%04d%02d%02d_%02d%02d%02d.%s",
+                 tmNow.tm_year + 1900, tmNow.tm_mon + 1, tmNow.tm_mday,
+                 tmNow.tm_hour, tmNow.tm_min, tmNow.tm_sec, ext);
+        _segmentStartDay = tmNow.tm_yday;
+        _segmentSequence++;
+    }
+    else
+    {
+        // The sequence counter resets every boot and FILE_WRITE
+        // truncates, so scan for the first free boot-relative name -
+        // otherwise a pre-NTP reboot (the brownout-loop case) would
+        // destroy the previous boot's segment
+        do
         {
-            writeHeader();
-            _logFile.close();
-        }
+            snprintf(_filename, sizeof(_filename), "/vawt_boot%03u.%s",
+                     (unsigned)_segmentSequence++, ext);
+        } while (SD.exists(_filename) && _segmentSequence < 1000);
+        _segmentStartDay = -1; // No daily rotation until time is known
     }
 
+    _logFile = SD.open(_filename, FILE_WRITE);
+    if (!_logFile)
+    {
+        Serial.println("[LOGGER] Failed to open log segment");
+        return false;
+    }
+
+    if (_format == LOG_FORMAT_CSV)
+    {
+        // Binary files are a bare record stream, the converter supplies
+        // the header
+        writeHeader();
+    }
+    _logFile.flush(); // Commit the directory entry before logging starts
+
+    _segmentBytes = 0;
+    _segmentStartTime = now;
+    Serial.printf("[LOGGER] New segment: %s\n", _filename);
     return true;
 }
 
+// Close the current segment and record it in the index file: one line
+// per segment with its time range and size, so retrieval tooling can
+// pick the right file without scanning any data.
+void DataLogger::closeSegment()
+{
+    if (!_logFile)
+        return;
+
+    _logFile.flush();
+    _logFile.close();
+
+    File index = SD.open(INDEX_FILENAME, FILE_APPEND);
+    if (index)
+    {
+        // filename,start_epoch,end_epoch,bytes
+        index.printf("%s,%ld,%ld,%u\n", _filename,
+                     (long)_segmentStartTime, (long)time(NULL),
+                     (unsigned)_segmentBytes);
+        index.close();
+    }
+}
+
+// Rotate when the open segment hits the size bound or the wall-clock day
+// changes. Runs on the I/O task after ring drains.
+void DataLogger::rotateIfNeeded()
+{
+    bool rotate = (_segmentBytes >= SEGMENT_MAX_BYTES);
+
+    if (!rotate && _segmentStartDay >= 0)
+    {
+        time_t now = time(NULL);
+        struct tm tmNow;
+        localtime_r(&now, &tmNow);
+        rotate = (tmNow.tm_yday != _segmentStartDay);
+    }
+
+    if (rotate)
+    {
+        closeSegment();
+        if (!openNewSegment())
+        {
+            _sdInitialized = false;
+        }
+        _bytesSinceSync = 0;
+    }
+}
+
+// Producer side. Formats the record on the stack and appends it to the
+// active RAM buffer - bounded time, no SD access, callable whether or not
+// the card came up (records are buffered and dropped only when both
+// buffers fill).
 void DataLogger::log(unsigned long timestamp, TurbineState state,
                      float windSpeed, float rpm, float voltage,
                      float current, float power, float lambda, float cp)
 {
-    if (!_sdInitialized)
+    // Every sample also feeds the per-minute summary stream, whatever
+    // the raw format
+    accumulateSummary(timestamp, state, windSpeed, rpm, power);
+
+    if (_format == LOG_FORMAT_BINARY || _format == LOG_FORMAT_DELTA)
+    {
+        // Pack a fixed-size record - no formatting, no String, 33 bytes
+        LogRecord record;
+        record.timestamp = timestamp;
+        record.state = (uint8_t)state;
+        record.windSpeed = windSpeed;
+        record.rpm = rpm;
+        record.voltage = voltage;
+        record.current = current;
+        record.power = power;
+        record.lambda = lambda;
+        record.cp = cp;
+
+        if (_format == LOG_FORMAT_DELTA)
+        {
+            appendDelta(record);
+        }
+        else
+        {
+            append((const char *)&record, sizeof(record));
+        }
         return;
+    }
 
     // Format CSV line
     char line[256];
     snprintf(line, sizeof(line),
              "%lu,%s,%.1f,%.0f,%.2f,%.2f,%.1f,%.2f,%.3f\n",
              timestamp,
-             stateToString(state).c_str(),
+             turbineStateName(state),
              windSpeed,
              rpm,
              voltage,
@@ -68,69 +272,437 @@ void DataLogger::log(unsigned long timestamp, TurbineState state,
              lambda,
              cp);
 
-    // Append to buffer
-    size_t lineLen = strlen(line);
-    if (_bufferPos + lineLen < sizeof(_buffer))
+    append(line, strlen(line));
+}
+
+// Quantize a record to the same fixed-point resolution the CSV format
+// uses (0.1 m/s wind, 1 RPM, 10 mV, 10 mA, 0.1 W, 0.01 λ, 0.001 Cp).
+// floor(x + 0.5) rounding, mirrored exactly by the offline decoder.
+void DataLogger::quantizeRecord(const LogRecord &record,
+                                int32_t out[DELTA_FIELD_COUNT])
+{
+    out[0] = (int32_t)record.timestamp;
+    out[1] = record.state;
+    out[2] = (int32_t)floorf(record.windSpeed * 10.0f + 0.5f);
+    out[3] = (int32_t)floorf(record.rpm + 0.5f);
+    out[4] = (int32_t)floorf(record.voltage * 100.0f + 0.5f);
+    out[5] = (int32_t)floorf(record.current * 100.0f + 0.5f);
+    out[6] = (int32_t)floorf(record.power * 10.0f + 0.5f);
+    out[7] = (int32_t)floorf(record.lambda * 100.0f + 0.5f);
+    out[8] = (int32_t)floorf(record.cp * 1000.0f + 0.5f);
+}
+
+// LEB128 varint, at most 5 bytes for 32 bits
+size_t DataLogger::encodeVarint(uint8_t *out, uint32_t value)
+{
+    size_t n = 0;
+    do
+    {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        out[n++] = byte | (value ? 0x80 : 0);
+    } while (value);
+    return n;
+}
+
+// Delta encoding: successive samples are highly correlated, so each
+// record stores zigzag-varint deltas of the quantized fields against the
+// previous record - typically 11-14 bytes instead of the 33-byte fixed
+// record. A tagged full keyframe every KEYFRAME_INTERVAL records keeps
+// segments seekable and bounds the cost of any corruption.
+void DataLogger::appendDelta(const LogRecord &record)
+{
+    int32_t quantized[DELTA_FIELD_COUNT];
+    quantizeRecord(record, quantized);
+
+    if (!_deltaHaveKey || _deltaRecordsSinceKey >= KEYFRAME_INTERVAL)
+    {
+        // Keyframe: tag + full packed record
+        uint8_t frame[1 + sizeof(LogRecord)];
+        frame[0] = TAG_KEYFRAME;
+        memcpy(frame + 1, &record, sizeof(LogRecord));
+        append((const char *)frame, sizeof(frame));
+
+        memcpy(_deltaPrev, quantized, sizeof(_deltaPrev));
+        _deltaHaveKey = true;
+        _deltaRecordsSinceKey = 0;
+        return;
+    }
+
+    // Delta record: tag + one zigzag varint per field
+    uint8_t frame[1 + DELTA_FIELD_COUNT * 5];
+    size_t pos = 0;
+    frame[pos++] = TAG_DELTA;
+    for (int i = 0; i < DELTA_FIELD_COUNT; i++)
+    {
+        int32_t delta = quantized[i] - _deltaPrev[i];
+        uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+        pos += encodeVarint(frame + pos, zigzag);
+        _deltaPrev[i] = quantized[i];
+    }
+    append((const char *)frame, pos);
+    _deltaRecordsSinceKey++;
+}
+
+// Producer side. Folds one sample into the running minute: O(1)
+// min/max/sum updates, no buffer walk. When the minute closes, the
+// finished record goes into the SPSC summary ring for the I/O task; a
+// full ring (card stalled for 4+ minutes) drops the minute and counts.
+void DataLogger::accumulateSummary(unsigned long timestamp, TurbineState state,
+                                   float windSpeed, float rpm, float power)
+{
+    if (_summarySamples == 0)
+    {
+        _summaryStartMs = timestamp;
+        _summaryPowerMin = _summaryPowerMax = power;
+        _summaryRpmMin = _summaryRpmMax = rpm;
+        _summaryWindMin = _summaryWindMax = windSpeed;
+    }
+    else
+    {
+        if (power < _summaryPowerMin) _summaryPowerMin = power;
+        if (power > _summaryPowerMax) _summaryPowerMax = power;
+        if (rpm < _summaryRpmMin) _summaryRpmMin = rpm;
+        if (rpm > _summaryRpmMax) _summaryRpmMax = rpm;
+        if (windSpeed < _summaryWindMin) _summaryWindMin = windSpeed;
+        if (windSpeed > _summaryWindMax) _summaryWindMax = windSpeed;
+    }
+    _summaryPowerSum += power;
+    _summaryRpmSum += rpm;
+    _summaryWindSum += windSpeed;
+    if (_summarySamples < 0xFFFF)
+    {
+        _summarySamples++;
+    }
+
+    if ((int)state >= 0 && (int)state < SUMMARY_STATE_COUNT)
+    {
+        _summaryStateSamples[state]++;
+    }
+    // Fault entries, not fault samples: a minute spent in FAULT counts
+    // once, a flapping fault counts each trip
+    if (state == STATE_FAULT && _summaryLastState != (int8_t)STATE_FAULT)
     {
-        strcpy(_buffer + _bufferPos, line);
-        _bufferPos += lineLen;
+        _summaryFaultEntries++;
+    }
+    _summaryLastState = (int8_t)state;
+
+    if (timestamp - _summaryStartMs < SUMMARY_INTERVAL_MS)
+    {
+        return;
+    }
+
+    // Minute complete: hand it to the consumer
+    uint32_t head = _summaryHead;
+    if (head - _summaryTail >= SUMMARY_RING_SIZE)
+    {
+        _summaryDropped++;
     }
     else
     {
-        flush(); // Buffer full, write to SD
-        strcpy(_buffer, line);
-        _bufferPos = lineLen;
+        SummaryRecord &rec = _summaryRing[head % SUMMARY_RING_SIZE];
+        rec.timestamp = timestamp;
+        rec.samples = _summarySamples;
+        rec.faultEntries = _summaryFaultEntries;
+        rec.powerMin = _summaryPowerMin;
+        rec.powerMean = _summaryPowerSum / _summarySamples;
+        rec.powerMax = _summaryPowerMax;
+        rec.rpmMin = _summaryRpmMin;
+        rec.rpmMean = _summaryRpmSum / _summarySamples;
+        rec.rpmMax = _summaryRpmMax;
+        rec.windMin = _summaryWindMin;
+        rec.windMean = _summaryWindSum / _summarySamples;
+        rec.windMax = _summaryWindMax;
+        for (int i = 0; i < SUMMARY_STATE_COUNT; i++)
+        {
+            rec.stateSamples[i] = _summaryStateSamples[i];
+        }
+        _summaryHead = head + 1; // Publish after the slot is written
     }
+
+    resetSummaryAccumulator();
 }
 
-void DataLogger::flush()
+void DataLogger::resetSummaryAccumulator()
+{
+    _summarySamples = 0;
+    _summaryFaultEntries = 0;
+    _summaryPowerSum = 0;
+    _summaryRpmSum = 0;
+    _summaryWindSum = 0;
+    for (int i = 0; i < SUMMARY_STATE_COUNT; i++)
+    {
+        _summaryStateSamples[i] = 0;
+    }
+    // _summaryLastState carries across minutes so a fault entry is never
+    // double-counted at a boundary
+}
+
+// Consumer side. Appends finished minutes to the summary file - a flush
+// per record is one commit a minute, cheap enough to make the file crash-
+// consistent. On a write failure the record stays queued; the raw log's
+// remount path restores the card and the next pass retries.
+void DataLogger::drainSummaryToCard()
+{
+    if (_summaryTail == _summaryHead)
+    {
+        return;
+    }
+
+    if (!_summaryFile)
+    {
+        _summaryFile = SD.open(SUMMARY_FILENAME, FILE_APPEND);
+        if (!_summaryFile)
+        {
+            return;
+        }
+    }
+
+    while (_summaryTail != _summaryHead)
+    {
+        const SummaryRecord &rec = _summaryRing[_summaryTail % SUMMARY_RING_SIZE];
+        if (_summaryFile.write((const uint8_t *)&rec, sizeof(rec)) != sizeof(rec))
+        {
+            _summaryFile.close(); // Card trouble; reopen on a later pass
+            return;
+        }
+        _summaryTail = _summaryTail + 1;
+    }
+    _summaryFile.flush();
+}
+
+void DataLogger::logRaw(const char *line)
+{
+    if (_format != LOG_FORMAT_CSV)
+        return; // Would corrupt the fixed-record binary stream
+
+    append(line, strlen(line));
+}
+
+// Append to the active buffer, sealing and swapping when it fills. The
+// only cross-core store is the _sealed flag (aligned 32-bit, atomic on
+// ESP32); if the other buffer is still awaiting drain, the record is
+// dropped rather than waiting on the SD card.
+void DataLogger::append(const char *data, size_t len)
+{
+    // A pending flush() request seals the active buffer early. Only the
+    // producer touches _active/_bufferPos, so the consumer signals via a
+    // flag instead of sealing the buffer itself.
+    if (_flushRequested && _bufferPos[_active] > 0 && !_sealed[1 - _active])
+    {
+        _flushRequested = 0;
+        _sealed[_active] = 1;
+        _active = 1 - _active;
+    }
+
+    if (_bufferPos[_active] + len > BUFFER_SIZE)
+    {
+        uint8_t other = 1 - _active;
+        if (_sealed[other])
+        {
+            // Consumer hasn't drained the other buffer yet (SD stalled
+            // or absent) - drop rather than block the control path
+            _droppedRecords++;
+            return;
+        }
+        _sealed[_active] = 1; // Hand the full buffer to the consumer
+        _active = other;
+    }
+
+    memcpy(_buffer[_active] + _bufferPos[_active], data, len);
+    _bufferPos[_active] += len;
+}
+
+// Consumer side. Moves sealed buffers into the staging ring, drains the
+// ring to the card (retrying the mount if the card vanished) and applies
+// the sync policy. Runs from the I/O task; this is the only place SD
+// latency is paid.
+void DataLogger::service()
+{
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        if (_sealed[i])
+        {
+            drainBuffer(i);
+        }
+    }
+
+    if (!_sdInitialized)
+    {
+        attemptRemount();
+    }
+    if (_sdInitialized)
+    {
+        drainRingToCard();
+        drainSummaryToCard();
+        maybeSync();
+    }
+}
+
+void DataLogger::drainBuffer(uint8_t index)
+{
+    // Into the staging ring, never straight to the card: the ring holds
+    // hours of backlog across card stalls, removals and remounts
+    ringWrite((uint8_t *)_buffer[index], _bufferPos[index]);
+    _bufferPos[index] = 0;
+    _sealed[index] = 0; // Return the buffer to the producer
+}
+
+// Append to the staging ring, evicting the oldest data when full. All
+// ring state is owned by the I/O task.
+void DataLogger::ringWrite(const uint8_t *data, size_t len)
+{
+    if (_ring == NULL || len >= _ringCapacity)
+        return;
+
+    // Evict oldest bytes if the backlog would not fit. In binary format
+    // the ring holds nothing but 33-byte fixed records (buffers seal on
+    // whole records), so eviction rounds up to a record boundary - an
+    // arbitrary byte cut would shift the frame alignment for the entire
+    // remaining backlog and the decoder has no way to resync. Delta
+    // format's converter rescans to the next plausible keyframe and CSV
+    // readers to the next newline, so those evict byte-exact.
+    size_t used = _ringHead - _ringTail;
+    size_t free = _ringCapacity - used - 1;
+    if (len > free)
+    {
+        size_t evict = len - free;
+        if (_format == LOG_FORMAT_BINARY)
+        {
+            size_t rec = sizeof(LogRecord);
+            evict = ((evict + rec - 1) / rec) * rec;
+            if (evict > used)
+                evict = used;
+        }
+        _ringTail += evict;
+        _ringOverflowBytes += evict;
+    }
+
+    for (size_t i = 0; i < len; i++)
+    {
+        _ring[(_ringHead + i) % _ringCapacity] = data[i];
+    }
+    _ringHead += len;
+}
+
+size_t DataLogger::getRingBacklog() const
 {
-    if (!_sdInitialized || _bufferPos == 0)
+    return _ringHead - _ringTail;
+}
+
+// Write up to RING_DRAIN_CHUNK staged bytes to the file. Bounded per
+// call so one service() pass never monopolizes the I/O task during a
+// large backfill.
+void DataLogger::drainRingToCard()
+{
+    size_t backlog = _ringHead - _ringTail;
+    if (backlog == 0)
         return;
+    if (backlog > RING_DRAIN_CHUNK)
+        backlog = RING_DRAIN_CHUNK;
+
+    // The ring is contiguous up to its wrap point
+    size_t tailOffset = _ringTail % _ringCapacity;
+    size_t contiguous = _ringCapacity - tailOffset;
+    if (backlog > contiguous)
+        backlog = contiguous;
 
-    _logFile = SD.open(_filename.c_str(), FILE_APPEND);
-    if (_logFile)
+    size_t written = _logFile.write(_ring + tailOffset, backlog);
+    if (written != backlog)
     {
-        _logFile.write((uint8_t *)_buffer, _bufferPos);
+        // Card vanished mid-write: drop back to ring-only mode and let
+        // the remount retry recover it. The unwritten bytes stay staged.
+        Serial.println("[LOGGER] Write failed - card lost, staging to RAM");
         _logFile.close();
-        _bufferPos = 0;
+        _sdInitialized = false;
+        _lastRemountAttempt = millis();
     }
-    else
+    _ringTail += written;
+    _bytesSinceSync += written;
+    _segmentBytes += written;
+
+    if (_sdInitialized)
     {
-        Serial.println("[LOGGER] Failed to open log file");
+        rotateIfNeeded();
     }
 }
 
-void DataLogger::close()
+// Periodic card recovery: after a failed begin() or a mid-run card loss,
+// try a full remount. On success the staged backlog backfills through
+// drainRingToCard() on subsequent service() passes.
+void DataLogger::attemptRemount()
 {
-    flush();
-    _sdInitialized = false;
+    unsigned long now = millis();
+    if (now - _lastRemountAttempt < SD_RETRY_INTERVAL_MS)
+        return;
+    _lastRemountAttempt = now;
+
+    SD.end();
+    if (mountCard())
+    {
+        Serial.printf("[LOGGER] Card recovered, backfilling %u KB\n",
+                      (unsigned)(getRingBacklog() / 1024));
+    }
 }
 
-void DataLogger::writeHeader()
+// Ask the producer to seal the active buffer on its next log() call,
+// then drain everything already sealed. Safe to call from the I/O task:
+// the active buffer is never touched from this side.
+void DataLogger::flush()
 {
-    _logFile.println("timestamp,state,wind_speed_ms,rotor_rpm,voltage_dc,current_dc,power_w,lambda,cp");
+    _flushRequested = 1;
+    service();
+}
+
+void DataLogger::setSyncPolicy(uint32_t intervalMs, size_t bytes)
+{
+    _syncIntervalMs = intervalMs;
+    _syncBytes = bytes;
+}
+
+// Commit buffered card data (FAT + directory entry) when the sync policy
+// says so. This is the expensive part of a flush, so it runs at the
+// configured cadence instead of on every append.
+void DataLogger::maybeSync()
+{
+    if (!_sdInitialized)
+        return;
+
+    unsigned long now = millis();
+    if (_bytesSinceSync >= _syncBytes ||
+        (now - _lastSyncTime >= _syncIntervalMs && _bytesSinceSync > 0))
+    {
+        _logFile.flush();
+        _lastSyncTime = now;
+        _bytesSinceSync = 0;
+    }
 }
 
-String DataLogger::stateToString(TurbineState state)
+// Shutdown path - caller guarantees the producer has stopped, so sealing
+// the active buffer from here is safe.
+void DataLogger::close()
 {
-    switch (state)
+    if (_bufferPos[_active] > 0 && !_sealed[_active])
+    {
+        _sealed[_active] = 1;
+    }
+    service();
+
+    // Flush the whole staged backlog before releasing the card
+    while (_sdInitialized && getRingBacklog() > 0)
+    {
+        drainRingToCard();
+    }
+    closeSegment(); // Records the final segment in the index
+    if (_summaryFile)
     {
-    case STATE_IDLE:
-        return "IDLE";
-    case STATE_STANDBY:
-        return "STANDBY";
-    case STATE_STARTUP:
-        return "STARTUP";
-    case STATE_MPPT:
-        return "MPPT";
-    case STATE_POWER_REGULATION:
-        return "POWER_REG";
-    case STATE_STALL:
-        return "STALL";
-    case STATE_FAULT:
-        return "FAULT";
-    default:
-        return "UNKNOWN";
+        _summaryFile.flush();
+        _summaryFile.close();
     }
+    _sdInitialized = false;
+}
+
+void DataLogger::writeHeader()
+{
+    _logFile.println("timestamp,state,wind_speed_ms,rotor_rpm,voltage_dc,current_dc,power_w,lambda,cp");
 }
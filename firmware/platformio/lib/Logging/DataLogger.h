@@ -7,28 +7,234 @@
 #include <SPI.h>
 #include "TurbineStateMachine.h"
 
+// On-card log encoding, selected at begin()
+enum LogFormat
+{
+    LOG_FORMAT_CSV,    // Human-readable text (default, matches analysis scripts)
+    LOG_FORMAT_BINARY, // Packed fixed-size records, ~half the write volume
+    LOG_FORMAT_DELTA   // Delta/varint-encoded records with periodic keyframes,
+                       // typically another ~3x smaller than binary
+};
+
+// Fixed-size binary log record (33 bytes packed). Field order matches the
+// CSV columns; analysis/python/convert_binary_log.py converts back to the
+// standard CSV for the analysis scripts.
+struct __attribute__((packed)) LogRecord
+{
+    uint32_t timestamp; // ms since boot
+    uint8_t state;      // TurbineState enum value
+    float windSpeed;    // m/s
+    float rpm;
+    float voltage;      // V
+    float current;      // A
+    float power;        // W
+    float lambda;       // Tip-speed ratio
+    float cp;           // Power coefficient
+};
+
+// One per-minute summary record (58 bytes packed). min/mean/max of the
+// dashboard quantities plus state residency and fault entries: a day is
+// ~80 KB regardless of the raw log rate, so routine monitoring pulls
+// this file instead of the multi-MB raw log.
+// analysis/python/convert_summary_log.py converts back to CSV.
+struct __attribute__((packed)) SummaryRecord
+{
+    uint32_t timestamp;       // ms since boot at minute close
+    uint16_t samples;         // Raw samples aggregated into this minute
+    uint16_t faultEntries;    // Transitions into FAULT during the minute
+    float powerMin;           // W
+    float powerMean;
+    float powerMax;
+    float rpmMin;
+    float rpmMean;
+    float rpmMax;
+    float windMin;            // m/s
+    float windMean;
+    float windMax;
+    uint16_t stateSamples[7]; // Residency: samples spent per TurbineState
+};
+
+/**
+ * Double-buffered SD logger with a lock-free producer/consumer split:
+ *
+ *   log()     - producer side, safe to call from the control task. Appends
+ *               to the active RAM buffer and returns in bounded time; it
+ *               never touches the SD card, even when the card is absent.
+ *               When both buffers are full the record is dropped and
+ *               counted.
+ *   service() - consumer side, call from the I/O task. Moves sealed
+ *               buffers into the PSRAM staging ring, drains the ring to
+ *               the card and applies the sync policy. All SD latency
+ *               lives here.
+ *
+ * Between the double buffer and the card sits a PSRAM ring sized for
+ * hours of records. Samples always land in the ring even with no card
+ * mounted; when a card appears (or a failed card remounts - retried
+ * every 10 s) the accumulated backlog is backfilled to the file. A
+ * pulled or corrupted card therefore costs a delayed flush, not data.
+ *
+ * Single-producer/single-consumer: the handoff is one aligned 32-bit
+ * flag store per buffer (atomic on ESP32), no locks and no disabling of
+ * interrupts on the producer path.
+ */
 class DataLogger
 {
 public:
     DataLogger();
 
-    bool begin(uint8_t csPin = 5);
+    bool begin(uint8_t csPin = 5, LogFormat format = LOG_FORMAT_CSV);
+
+    // Producer side (control task) - bounded time, never blocks on SD
     void log(unsigned long timestamp, TurbineState state,
              float windSpeed, float rpm, float voltage,
              float current, float power, float lambda, float cp);
+
+    /**
+     * Append a preformatted text line (e.g. '#PROF' instrumentation
+     * records) through the same buffered path as log(). CSV format only:
+     * in binary mode the line is dropped so the fixed-record stream
+     * stays parseable.
+     */
+    void logRaw(const char *line);
+
+    // Consumer side (I/O task) - drains sealed buffers to the card
+    void service();
+
     void flush();
     void close();
 
+    /**
+     * Set how often buffered data is committed to the card (FAT/directory
+     * update). Writes between syncs are append-only sequential I/O on the
+     * already-open file. Worst-case data loss on power failure is one
+     * sync interval.
+     */
+    void setSyncPolicy(uint32_t intervalMs, size_t bytes);
+
+    // Records dropped because both buffers were full (SD stalled/absent)
+    uint32_t getDroppedRecords() const { return _droppedRecords; }
+
+    // Finished minutes lost because the summary ring was full
+    uint32_t getDroppedSummaries() const { return _summaryDropped; }
+
+    // Bytes evicted from the staging ring before reaching the card
+    uint32_t getRingOverflowBytes() const { return _ringOverflowBytes; }
+
+    // Bytes staged in PSRAM awaiting the card
+    size_t getRingBacklog() const;
+
 private:
+    static const size_t BUFFER_SIZE = 512;
+
+    // Staging ring: ~2 MB of PSRAM holds 17+ hours of 1 Hz CSV records
+    // (days of binary ones); without PSRAM a small heap ring still rides
+    // out brief card stalls
+    static const size_t PSRAM_RING_BYTES = 2 * 1024 * 1024;
+    static const size_t HEAP_RING_BYTES = 16 * 1024;
+    static const size_t RING_DRAIN_CHUNK = 8 * 1024; // Max SD write per service()
+    static const uint32_t SD_RETRY_INTERVAL_MS = 10000;
+
+    // Delta format framing: a tagged keyframe (full LogRecord) every
+    // KEYFRAME_INTERVAL records bounds both error propagation and how
+    // much of a segment is undecodable after mid-stream truncation
+    static const uint8_t TAG_KEYFRAME = 0xFF;
+    static const uint8_t TAG_DELTA = 0xFE;
+    static const uint8_t KEYFRAME_INTERVAL = 64;
+    static const int DELTA_FIELD_COUNT = 9;
+
+    // Rotation: a segment closes at 8 MB or on a wall-clock day change,
+    // whichever comes first. Bounds FAT append cost and makes
+    // 'yesterday's data' one small file instead of a scan of one big one.
+    static const size_t SEGMENT_MAX_BYTES = 8 * 1024 * 1024;
+    static const char *INDEX_FILENAME;
+
+    // Summary stream: one record per minute into its own small file
+    // (append-forever; at ~80 KB/day rotation would be pointless)
+    static const uint32_t SUMMARY_INTERVAL_MS = 60000;
+    static const uint32_t SUMMARY_RING_SIZE = 4; // Power of two
+    static const int SUMMARY_STATE_COUNT = 7;    // Matches TurbineState
+    static const char *SUMMARY_FILENAME;
+
     File _logFile;
-    String _filename;
+    char _filename[40]; // Fixed storage: no String, no heap churn
     uint8_t _csPin;
     bool _sdInitialized;
-    char _buffer[512];
-    size_t _bufferPos;
+    LogFormat _format;
+
+    // Double buffer. The producer owns _buffer[_active] until it seals it
+    // (_sealed[i] = true); the consumer owns sealed buffers until it
+    // clears the flag. _sealed stores are the only cross-core handoff.
+    char _buffer[2][BUFFER_SIZE];
+    size_t _bufferPos[2];
+    volatile uint32_t _sealed[2];
+    volatile uint32_t _flushRequested;
+    uint8_t _active;
+    uint32_t _droppedRecords;
+
+    // PSRAM staging ring (consumer-side only: all indices are touched
+    // exclusively from the I/O task, so no atomics needed here)
+    uint8_t *_ring;
+    size_t _ringCapacity;
+    size_t _ringHead; // Write position
+    size_t _ringTail; // Read position
+    uint32_t _ringOverflowBytes;
+    unsigned long _lastRemountAttempt;
+
+    // Current segment bookkeeping (I/O task only)
+    size_t _segmentBytes;      // Bytes written to the open segment
+    time_t _segmentStartTime;  // Wall time at segment open (0 if unsynced)
+    int _segmentStartDay;      // Day-of-year at open, for daily rotation
+    uint32_t _segmentSequence; // Fallback numbering before NTP sync
+
+    // Sync policy: commit to card every N ms or M bytes, whichever first
+    uint32_t _syncIntervalMs;
+    size_t _syncBytes;
+    unsigned long _lastSyncTime;
+    size_t _bytesSinceSync;
+
+    // Delta encoder state (producer side only)
+    int32_t _deltaPrev[DELTA_FIELD_COUNT];
+    bool _deltaHaveKey;
+    uint8_t _deltaRecordsSinceKey;
+
+    // Per-minute summary accumulator (producer side only)
+    unsigned long _summaryStartMs;
+    uint16_t _summarySamples;
+    uint16_t _summaryFaultEntries;
+    int8_t _summaryLastState; // -1 before the first sample
+    float _summaryPowerMin, _summaryPowerMax, _summaryPowerSum;
+    float _summaryRpmMin, _summaryRpmMax, _summaryRpmSum;
+    float _summaryWindMin, _summaryWindMax, _summaryWindSum;
+    uint16_t _summaryStateSamples[SUMMARY_STATE_COUNT];
+
+    // SPSC handoff for finished minutes - same volatile-index ring as
+    // the sample path, one slot per SummaryRecord
+    SummaryRecord _summaryRing[SUMMARY_RING_SIZE];
+    volatile uint32_t _summaryHead;
+    volatile uint32_t _summaryTail;
+    uint32_t _summaryDropped;
+
+    File _summaryFile;
 
+    void append(const char *data, size_t len);
+    void appendDelta(const LogRecord &record);
+    void accumulateSummary(unsigned long timestamp, TurbineState state,
+                           float windSpeed, float rpm, float power);
+    void resetSummaryAccumulator();
+    void drainSummaryToCard();
+    static void quantizeRecord(const LogRecord &record,
+                               int32_t out[DELTA_FIELD_COUNT]);
+    static size_t encodeVarint(uint8_t *out, uint32_t value);
+    void drainBuffer(uint8_t index);
+    bool mountCard();
+    bool openNewSegment();
+    void rotateIfNeeded();
+    void closeSegment();
+    void attemptRemount();
+    void ringWrite(const uint8_t *data, size_t len);
+    void drainRingToCard();
+    void maybeSync();
     void writeHeader();
-    String stateToString(TurbineState state);
 };
 
 #endif
@@ -0,0 +1,73 @@
+/**
+ * @file CpLambdaTable.h
+ * @brief Compile-time Cp-λ lookup table for feedforward MPPT
+ *
+ * Generates the helical-VAWT power coefficient curve
+ *     Cp(λ) = Cp_max · exp(−(λ − λ_opt)² / (2·0.8²)),  0.5 ≤ λ ≤ 4.0
+ * (the same model as analysis/matlab/generate_cp_lambda_curves.m) as a
+ * constexpr array, parameterized by TurbineConfig - the table lands in
+ * flash at build time, nothing is computed at startup, and a lookup is
+ * one index plus a linear interpolation.
+ */
+
+#ifndef CP_LAMBDA_TABLE_H
+#define CP_LAMBDA_TABLE_H
+
+#include "TurbineConfig.h"
+
+namespace cplambda {
+
+// constexpr e^x for x ≤ 0 via (1 + x/1024)^1024 (ten squarings);
+// accurate to well under 1% over the table's exponent range, which is
+// far tighter than the Cp model itself
+constexpr float expNeg(float x) {
+    float base = 1.0f + x / 1024.0f;
+    for (int i = 0; i < 10; i++) {
+        base *= base;
+    }
+    return base;
+}
+
+struct Table {
+    static constexpr int SIZE = 81;           // λ = 0.00 .. 4.00
+    static constexpr float LAMBDA_STEP = 0.05f;
+    static constexpr float GAUSSIAN_WIDTH = 0.8f; // Curve width (matlab model)
+
+    float cp[SIZE];
+
+    constexpr Table() : cp() {
+        for (int i = 0; i < SIZE; i++) {
+            float lambda = i * LAMBDA_STEP;
+            if (lambda >= 0.5f && lambda <= 4.0f) {
+                float d = lambda - TurbineConfig::LAMBDA_OPT;
+                cp[i] = TurbineConfig::CP_MAX *
+                        expNeg(-(d * d) / (2.0f * GAUSSIAN_WIDTH * GAUSSIAN_WIDTH));
+            } else {
+                cp[i] = 0.0f;
+            }
+        }
+    }
+};
+
+inline constexpr Table TABLE{};
+
+/**
+ * @brief Interpolated Cp at a given tip-speed ratio
+ * @param lambda Tip-speed ratio
+ * @return Power coefficient, 0 outside the operating band
+ *
+ * constexpr so derived tables (e.g. WindEstimator's inverse lookup) can
+ * be generated from it at compile time too.
+ */
+inline constexpr float cpAt(float lambda) {
+    if (lambda <= 0.0f) return 0.0f;
+    float pos = lambda / Table::LAMBDA_STEP;
+    int idx = (int)pos;
+    if (idx >= Table::SIZE - 1) return 0.0f;
+    float frac = pos - idx;
+    return TABLE.cp[idx] + frac * (TABLE.cp[idx + 1] - TABLE.cp[idx]);
+}
+
+} // namespace cplambda
+
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file MPPTCheckpoint.cpp
+ * @brief Persistent MPPT warm-start state in NVS (ESP32 only)
+ */
+
+#ifdef ESP32
+
+#include "MPPTCheckpoint.h"
+#include <Preferences.h>
+#include <time.h>
+
+// One NVS namespace, one blob key. Preferences rewrites the entry in
+// place (NVS wear-levels underneath), so repeated saves do not grow the
+// partition.
+static const char *NVS_NAMESPACE = "vawt-mppt";
+static const char *NVS_KEY = "ckpt";
+
+// NTP-synced clocks read far past this; an unsynced clock reads ~1970
+static const time_t EPOCH_VALID_MIN = 1600000000;
+
+bool MPPTCheckpoint::restoreOrReset(MPPTController &mppt) {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true)) {  // Read-only; fails on first boot
+        mppt.reset();
+        return false;
+    }
+
+    StoredCheckpoint stored;
+    size_t len = prefs.getBytes(NVS_KEY, &stored, sizeof(stored));
+    prefs.end();
+
+    if (len != sizeof(stored) || stored.magic != MAGIC) {
+        mppt.reset();
+        return false;
+    }
+
+    // Age check only when both timestamps are trustworthy; see header
+    time_t now = time(NULL);
+    if (stored.savedEpoch >= EPOCH_VALID_MIN && now >= EPOCH_VALID_MIN) {
+        if ((uint32_t)(now - stored.savedEpoch) > CHECKPOINT_MAX_AGE_S) {
+            Serial.printf("[MPPT] Checkpoint stale (%lus old), cold start\n",
+                          (unsigned long)(now - stored.savedEpoch));
+            mppt.reset();
+            return false;
+        }
+    }
+
+    mppt.restore(stored.snap);
+    Serial.printf("[MPPT] Warm start: duty=%.2f dir=%+d n=%u\n",
+                  stored.snap.dutyCycle, stored.snap.direction,
+                  stored.snap.sampleCount);
+    return true;
+}
+
+void MPPTCheckpoint::save(const MPPTController &mppt) {
+    StoredCheckpoint stored;
+    stored.magic = MAGIC;
+    time_t now = time(NULL);
+    stored.savedEpoch = (now >= EPOCH_VALID_MIN) ? (uint32_t)now : 0;
+    stored.snap = mppt.snapshot();
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        return;  // NVS unavailable; next interval retries
+    }
+    prefs.putBytes(NVS_KEY, &stored, sizeof(stored));
+    prefs.end();
+}
+
+#endif // ESP32
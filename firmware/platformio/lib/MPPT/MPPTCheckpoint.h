@@ -0,0 +1,69 @@
+/**
+ * @file MPPTCheckpoint.h
+ * @brief Persistent MPPT warm-start state in NVS (ESP32 only)
+ *
+ * After a brownout or watchdog reset the MPPT normally restarts from
+ * dutyCycle = 0.3 with empty statistics, then spends 10 s refilling the
+ * wind window and minutes hill-climbing back to the operating point -
+ * exactly during the storm conditions that caused the reset. This class
+ * checkpoints an MPPTSnapshot to NVS periodically and restores it on
+ * boot when it is recent, so the search resumes where it left off.
+ */
+
+#ifndef MPPTCHECKPOINT_H
+#define MPPTCHECKPOINT_H
+
+#ifdef ESP32
+
+#include <Arduino.h>
+#include "MPPTController.h"
+
+class MPPTCheckpoint {
+public:
+    // Checkpoint cadence: 60 s keeps the restored operating point within
+    // one adaptation window of reality while writing <1 KB/min to NVS
+    // (wear-leveled; decades of margin at this rate)
+    static const uint32_t SAVE_INTERVAL_MS = 60000;
+
+    /**
+     * @brief Restore the MPPT from NVS, or reset() if no usable checkpoint
+     *
+     * A checkpoint is usable when it exists, matches the current layout
+     * version, and is recent: under CHECKPOINT_MAX_AGE_S by wall clock
+     * when both the stored and current time are NTP-valid. When the
+     * clock is not yet synced (typical right after a brownout, before
+     * NTP) the age cannot be judged and the checkpoint is accepted - a
+     * brownout loop is seconds long, and a genuinely stale duty cycle is
+     * still constrained to the safe range and corrected by the HCS.
+     *
+     * Call from setup(), before the control task starts.
+     * @return true if a checkpoint was restored, false on cold reset
+     */
+    static bool restoreOrReset(MPPTController &mppt);
+
+    /**
+     * @brief Checkpoint the current search state to NVS
+     *
+     * Call from the I/O task (NVS commits touch flash and can take
+     * milliseconds); rate-limit with SAVE_INTERVAL_MS.
+     */
+    static void save(const MPPTController &mppt);
+
+private:
+    // Reject checkpoints older than this when wall time is available on
+    // both sides; wind conditions decorrelate well within 10 minutes
+    static const uint32_t CHECKPOINT_MAX_AGE_S = 600;
+
+    static const uint32_t MAGIC = 0x4D505031; // 'MPP1'
+
+    // On-flash layout; bump MAGIC when fields change
+    struct __attribute__((packed)) StoredCheckpoint {
+        uint32_t magic;
+        uint32_t savedEpoch; // time(NULL) at save, 0 if clock unsynced
+        MPPTSnapshot snap;
+    };
+};
+
+#endif // ESP32
+
+#endif
@@ -14,17 +14,21 @@
  */
 
 #include "MPPTController.h"
+#include "CpLambdaTable.h"
 #include <Arduino.h>
 
 // Constructor
-MPPTController::MPPTController(float lambdaOpt) 
+MPPTController::MPPTController(float lambdaOpt)
     : lambdaOpt(lambdaOpt),
+      mode(MPPT_MODE_HCS),
       dutyCycle(0.3),           // Initial duty cycle (30% - safe startup)
       lastPower(0),
       stepSize(0.02),           // Base step size (2%)
       direction(1),
       bufferIndex(0),
-      sampleCount(0)
+      sampleCount(0),
+      windSum(0),
+      windSumSq(0)
 {
     // Initialize wind speed buffer to zero
     for (int i = 0; i < WIND_BUFFER_SIZE; i++) {
@@ -40,13 +44,11 @@ MPPTController::MPPTController(float lambdaOpt)
  * @return Updated PWM duty cycle (0.0-1.0)
  * 
  * @note Adaptive step size activates after 100 samples (10s) for stable σ_v
+ * @note Does not feed the wind window - the caller pushes samples via
+ *       pushWindSample() at 10 Hz in every state, so the window stays
+ *       live when MPPT is not the active strategy
  */
 float MPPTController::update(float power, float windSpeed) {
-    // Store wind speed in circular buffer for turbulence calculation
-    windSpeedBuffer[bufferIndex] = windSpeed;
-    bufferIndex = (bufferIndex + 1) % WIND_BUFFER_SIZE;
-    if (sampleCount < WIND_BUFFER_SIZE) sampleCount++;
-    
     // Calculate adaptive step based on wind variability
     float stepSize = calculateAdaptiveStep(windSpeed);
     
@@ -71,17 +73,99 @@ float MPPTController::update(float power, float windSpeed) {
     return dutyCycle;
 }
 
+/**
+ * @brief Hybrid update: Cp-λ feedforward placement + HCS refinement
+ *
+ * The hill-climb search alone re-searches from scratch after every gust,
+ * losing energy for tens of seconds. Here the measured tip-speed ratio
+ * places the duty cycle near the optimum first:
+ * - λ below λ_opt (rotor over-loaded, typical right after a gust) →
+ *   shed load by scaling the duty down, letting the rotor accelerate
+ * - λ above λ_opt (under-loaded) → add load
+ * The correction is weighted by distance from the Cp peak (via the
+ * precomputed table): far from the peak the feedforward dominates and
+ * re-convergence is a single step; at the peak the weight vanishes and
+ * the turbulence-adaptive HCS refines as before.
+ */
+float MPPTController::update(float power, float windSpeed, float rpm) {
+    if (mode == MPPT_MODE_HYBRID && windSpeed > 0.5 && rpm > 0.0) {
+        float lambda = (rpm * TurbineConfig::TIP_SPEED_PER_RPM) / windSpeed;
+        float cpRatio = cplambda::cpAt(lambda) / TurbineConfig::CP_MAX;
+        float weight = 1.0 - cpRatio;  // 0 at the peak, →1 far away
+
+        float dutyFF = constrain(dutyCycle * (lambda / lambdaOpt), 0.1, 0.9);
+        dutyCycle = (1.0 - weight) * dutyCycle + weight * dutyFF;
+    }
+
+    // HCS refinement (adapts the step from the wind window statistics)
+    return update(power, windSpeed);
+}
+
+/**
+ * @brief Select the MPPT strategy
+ */
+void MPPTController::setMode(MPPTMode newMode) {
+    mode = newMode;
+}
+
+/**
+ * @brief Push a wind speed sample into the rolling statistics window
+ *
+ * Maintains the circular buffer plus running Σv and Σv² so the mean and
+ * σ_v are available in O(1) to both the step adaptation and the TI
+ * diagnostic — no full buffer walk per tick. The sums subtract the
+ * evicted sample as it leaves the window, so cost is constant even if
+ * WIND_BUFFER_SIZE grows for longer averaging windows.
+ */
+void MPPTController::pushWindSample(float windSpeed) {
+    float evicted = windSpeedBuffer[bufferIndex];
+    if (sampleCount == WIND_BUFFER_SIZE) {
+        // Window full: the overwritten sample leaves the sums
+        windSum -= evicted;
+        windSumSq -= evicted * evicted;
+    } else {
+        sampleCount++;
+    }
+    windSpeedBuffer[bufferIndex] = windSpeed;
+    bufferIndex = (bufferIndex + 1) % WIND_BUFFER_SIZE;
+    windSum += windSpeed;
+    windSumSq += windSpeed * windSpeed;
+}
+
+/**
+ * @brief Rolling mean wind speed over the current window - O(1)
+ */
+float MPPTController::windMean() const {
+    if (sampleCount == 0) return 0.0;
+    return windSum / sampleCount;
+}
+
+/**
+ * @brief Rolling wind speed standard deviation (σ_v) - O(1)
+ *
+ * Uses the computational formula σ² = E[v²] − E[v]²; float rounding can
+ * make the difference slightly negative in perfectly steady wind, so it
+ * is clamped at zero.
+ */
+float MPPTController::windSigma() const {
+    if (sampleCount == 0) return 0.0;
+    float mean = windSum / sampleCount;
+    float variance = (windSumSq / sampleCount) - mean * mean;
+    if (variance < 0.0) variance = 0.0;  // Guard float cancellation
+    return sqrt(variance);
+}
+
 /**
  * @brief Calculate adaptive MPPT step size based on wind turbulence
- * 
+ *
  * Strategy:
  * - Low turbulence (σ_v < 0.5 m/s): Large steps for fast convergence
  * - High turbulence (σ_v > 1.0 m/s): Small steps to reduce oscillation
  * - Linear interpolation between 0.5-1.0 m/s
- * 
+ *
  * @param windSpeed Current wind speed (unused, kept for future enhancements)
  * @return Adaptive step size (0.005 to 0.02)
- * 
+ *
  * @note Requires ≥100 samples (10s) for reliable variance estimation
  */
 float MPPTController::calculateAdaptiveStep(float windSpeed) {
@@ -89,25 +173,10 @@ float MPPTController::calculateAdaptiveStep(float windSpeed) {
     if (sampleCount < WIND_BUFFER_SIZE) {
         return BASE_STEP_SIZE;  // Use base step during warm-up
     }
-    
-    // -------------------------------------------------------------------
-    // Calculate Wind Speed Standard Deviation (σ_v)
-    // -------------------------------------------------------------------
-    // Step 1: Compute mean wind speed over buffer window
-    float mean = 0.0;
-    for (int i = 0; i < WIND_BUFFER_SIZE; i++) {
-        mean += windSpeedBuffer[i];
-    }
-    mean /= WIND_BUFFER_SIZE;
-    
-    // Step 2: Compute variance
-    float variance = 0.0;
-    for (int i = 0; i < WIND_BUFFER_SIZE; i++) {
-        float diff = windSpeedBuffer[i] - mean;
-        variance += diff * diff;
-    }
-    float sigma = sqrt(variance / WIND_BUFFER_SIZE);  // Standard deviation
-    
+
+    // Rolling σ_v maintained incrementally by pushWindSample()
+    float sigma = windSigma();
+
     // -------------------------------------------------------------------
     // Adaptive Step Size Calculation
     // -------------------------------------------------------------------
@@ -133,32 +202,96 @@ void MPPTController::reset() {
     direction = 1;
     sampleCount = 0;
     bufferIndex = 0;
+    windSum = 0;
+    windSumSq = 0;
     for (int i = 0; i < WIND_BUFFER_SIZE; i++) {
         windSpeedBuffer[i] = 0;
     }
 }
 
+/**
+ * @brief Capture the search state for checkpointing
+ *
+ * Only the first two moments of the wind window are stored, not the raw
+ * buffer - enough to resume adaptive stepping, and small enough that a
+ * periodic NVS write is cheap on flash wear.
+ */
+MPPTSnapshot MPPTController::snapshot() const {
+    MPPTSnapshot snap;
+    snap.dutyCycle = dutyCycle;
+    snap.lastPower = lastPower;
+    snap.direction = direction;
+    snap.sampleCount = sampleCount;
+    snap.windMean = windMean();
+    snap.windSigma = windSigma();
+    return snap;
+}
+
+/**
+ * @brief Resume from a checkpoint instead of a cold reset()
+ *
+ * The wind window is rebuilt as alternating mean+σ / mean−σ samples,
+ * which reproduces the stored mean and σ_v; the sums are then recomputed
+ * from the synthetic buffer so the incremental-statistics invariant
+ * (sums match buffer contents) holds as real samples evict them.
+ */
+void MPPTController::restore(const MPPTSnapshot &snap) {
+    dutyCycle = constrain(snap.dutyCycle, 0.1, 0.9);
+    lastPower = snap.lastPower;
+    direction = (snap.direction >= 0) ? 1 : -1;
+
+    sampleCount = min((int)snap.sampleCount, WIND_BUFFER_SIZE);
+    bufferIndex = sampleCount % WIND_BUFFER_SIZE;
+    float mean = max(snap.windMean, 0.0f);
+    float sigma = max(snap.windSigma, 0.0f);
+    windSum = 0;
+    windSumSq = 0;
+    for (int i = 0; i < WIND_BUFFER_SIZE; i++) {
+        float v = 0;
+        if (i < sampleCount) {
+            v = (i & 1) ? (mean - sigma) : (mean + sigma);
+            if (v < 0) v = 0;  // Low mean, high σ: clip rather than go negative
+            windSum += v;
+            windSumSq += v * v;
+        }
+        windSpeedBuffer[i] = v;
+    }
+}
+
+/**
+ * @brief Copy the wind window in chronological order (oldest first)
+ *
+ * Unrolls the circular buffer so spectral/trend analysis sees samples in
+ * time order. O(N) memcpy-style walk; called at 1 Hz by the gust
+ * detector, not on the 10 Hz MPPT path.
+ */
+int MPPTController::copyWindWindow(float *dst) const {
+    if (sampleCount < WIND_BUFFER_SIZE) {
+        // Not yet wrapped: samples [0, sampleCount) are already in order
+        for (int i = 0; i < sampleCount; i++) {
+            dst[i] = windSpeedBuffer[i];
+        }
+        return sampleCount;
+    }
+    // Full window: oldest sample sits at the next write position
+    for (int i = 0; i < WIND_BUFFER_SIZE; i++) {
+        dst[i] = windSpeedBuffer[(bufferIndex + i) % WIND_BUFFER_SIZE];
+    }
+    return WIND_BUFFER_SIZE;
+}
+
 /**
  * @brief Get current turbulence intensity (for logging/debugging)
+ *
+ * Shares the rolling statistics with calculateAdaptiveStep(), so the
+ * diagnostic is O(1) and the two paths can never disagree.
  * @return σ_v / mean wind speed (dimensionless)
  */
 float MPPTController::getTurbulenceIntensity() {
     if (sampleCount < WIND_BUFFER_SIZE) return 0.0;
-    
-    float mean = 0.0;
-    for (int i = 0; i < WIND_BUFFER_SIZE; i++) {
-        mean += windSpeedBuffer[i];
-    }
-    mean /= WIND_BUFFER_SIZE;
-    
+
+    float mean = windMean();
     if (mean < 0.5) return 0.0;  // Avoid division by zero at low winds
-    
-    float variance = 0.0;
-    for (int i = 0; i < WIND_BUFFER_SIZE; i++) {
-        float diff = windSpeedBuffer[i] - mean;
-        variance += diff * diff;
-    }
-    float sigma = sqrt(variance / WIND_BUFFER_SIZE);
-    
-    return sigma / mean;  // Turbulence intensity (TI)
+
+    return windSigma() / mean;  // Turbulence intensity (TI)
 }
\ No newline at end of file
@@ -8,6 +8,29 @@
 
 #include <Arduino.h>
 
+// MPPT strategy
+enum MPPTMode {
+    MPPT_MODE_HCS,    // Pure hill-climb search (legacy behavior)
+    MPPT_MODE_HYBRID  // Cp-λ feedforward + HCS refinement around it
+};
+
+/**
+ * @brief Compact snapshot of the MPPT search state for warm-starting
+ *
+ * Holds the operating point plus the first two moments (mean, σ_v) of
+ * the rolling wind window instead of the raw 100-sample buffer, so a
+ * checkpoint is ~20 bytes. restore() rebuilds a synthetic window with
+ * matching statistics. Persisted to NVS by MPPTCheckpoint.
+ */
+struct MPPTSnapshot {
+    float dutyCycle;     // Operating point at checkpoint time
+    float lastPower;     // For the first hill-climb comparison
+    int8_t direction;    // Search direction (+1 or -1)
+    uint16_t sampleCount; // Window fill level
+    float windMean;      // Rolling mean wind speed (m/s)
+    float windSigma;     // Rolling σ_v (m/s)
+};
+
 class MPPTController {
 public:
     /**
@@ -24,11 +47,51 @@ public:
      * @return PWM duty cycle (0.0-1.0)
      */
     float update(float power, float windSpeed);
-    
+
+    /**
+     * @brief Update with tip-speed-ratio feedforward (MPPT_MODE_HYBRID)
+     *
+     * Uses measured RPM and wind speed to place the duty near the Cp-λ
+     * optimum in one step, then lets the HCS refine around it. Falls
+     * back to plain HCS when rpm/wind data is unusable or in
+     * MPPT_MODE_HCS.
+     *
+     * @param power Current power output (W)
+     * @param windSpeed Current wind speed (m/s)
+     * @param rpm Measured rotor speed
+     * @return PWM duty cycle (0.0-1.0)
+     */
+    float update(float power, float windSpeed, float rpm);
+
+    /**
+     * @brief Select the MPPT strategy (default MPPT_MODE_HCS)
+     */
+    void setMode(MPPTMode mode);
+
     /**
      * @brief Reset MPPT state
      */
     void reset();
+
+    /**
+     * @brief Capture the search state for checkpointing
+     *
+     * Safe to call from the I/O task while update() runs on the control
+     * core: all captured fields are aligned 32-bit (or smaller) values,
+     * so reads cannot tear, and a checkpoint straddling one update step
+     * is still a valid warm-start hint.
+     */
+    MPPTSnapshot snapshot() const;
+
+    /**
+     * @brief Resume from a checkpoint instead of a cold reset()
+     *
+     * Restores the operating point and rebuilds the rolling wind window
+     * from the stored mean/σ_v (alternating mean±σ samples), so adaptive
+     * stepping is active immediately instead of after a 10 s warm-up.
+     * Call before the control task starts.
+     */
+    void restore(const MPPTSnapshot &snap);
     
     /**
      * @brief Get current turbulence intensity for diagnostics
@@ -36,10 +99,37 @@ public:
      */
     float getTurbulenceIntensity();
 
+    // Window length of the rolling wind history (10 s @ 10 Hz)
+    static const int WIND_WINDOW = 100;
+
+    /**
+     * @brief Push a wind speed sample into the rolling window
+     *
+     * Updates the circular buffer and the running Σv / Σv² sums in O(1).
+     * Called by the control loop at 10 Hz in every state - update() does
+     * not feed the window itself, so turbulence statistics and the gust
+     * detector's spectral scan stay live even when MPPT is not the
+     * active strategy (POWER_REGULATION, STALL).
+     * @param windSpeed New wind speed sample (m/s)
+     */
+    void pushWindSample(float windSpeed);
+
+    /**
+     * @brief Copy the wind window in chronological order (oldest first)
+     *
+     * For downstream analysis stages (e.g. GustDetector's spectral
+     * scan). Same-task use only - the buffer is owned by the control
+     * task that calls pushWindSample().
+     * @param dst Destination, at least WIND_WINDOW floats
+     * @return Number of valid samples copied
+     */
+    int copyWindWindow(float *dst) const;
+
 private:
     // Configuration
     float lambdaOpt;                    // Optimal tip-speed ratio
-    static const int WIND_BUFFER_SIZE = 100;  // 10s @ 10Hz
+    MPPTMode mode;                      // Active strategy
+    static const int WIND_BUFFER_SIZE = WIND_WINDOW;  // 10s @ 10Hz
     static constexpr float BASE_STEP_SIZE = 0.02;  // 2% base step
     
     // State variables
@@ -52,7 +142,25 @@ private:
     float windSpeedBuffer[100];         // Circular buffer for σ_v calculation
     int bufferIndex;                    // Current buffer write position
     int sampleCount;                    // Number of samples collected
-    
+
+    // Incremental statistics over the buffer window (O(1) per sample):
+    // running Σv and Σv² are updated as samples enter/leave the circular
+    // buffer, so mean and σ_v never require a full buffer walk
+    float windSum;                      // Σ v over current window
+    float windSumSq;                    // Σ v² over current window
+
+    /**
+     * @brief Rolling mean wind speed over the buffer window
+     * @return Mean wind speed (m/s), 0 if no samples yet
+     */
+    float windMean() const;
+
+    /**
+     * @brief Rolling wind speed standard deviation (σ_v)
+     * @return σ_v (m/s), 0 if no samples yet
+     */
+    float windSigma() const;
+
     /**
      * @brief Calculate adaptive step size based on wind variance
      * @param windSpeed Current wind speed (m/s)
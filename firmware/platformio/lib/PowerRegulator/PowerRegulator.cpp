@@ -0,0 +1,99 @@
+#include "PowerRegulator.h"
+
+// The P term is recomputed each step; only the integrator is state, and
+// with arm() it doubles as the operating-point bias (the old code's
+// fixed 0.5 base plus its hidden static integrator, minus the windup).
+
+#ifdef VAWT_POWER_REG_FIXED
+// Q16.16 helpers for the fixed-point integrator core
+static inline int32_t toQ16(float x)
+{
+    return (int32_t)(x * 65536.0f);
+}
+static inline float fromQ16(int32_t x)
+{
+    return (float)x / 65536.0f;
+}
+#endif
+
+PowerRegulator::PowerRegulator(float targetPower, float kp, float ki)
+    : _targetPower(targetPower),
+      _kp(kp),
+      _ki(ki)
+{
+    reset();
+}
+
+void PowerRegulator::setTarget(float targetPower)
+{
+    _targetPower = targetPower;
+}
+
+void PowerRegulator::setGains(float kp, float ki)
+{
+    _kp = kp;
+    _ki = ki;
+}
+
+void PowerRegulator::reset()
+{
+#ifdef VAWT_POWER_REG_FIXED
+    _integratorQ16 = toQ16(0.5f);
+#else
+    _integrator = 0.5f; // The old base operating point
+#endif
+}
+
+void PowerRegulator::arm(float currentDuty)
+{
+    float duty = constrain(currentDuty, DUTY_MIN, DUTY_MAX);
+#ifdef VAWT_POWER_REG_FIXED
+    _integratorQ16 = toQ16(duty);
+#else
+    _integrator = duty;
+#endif
+}
+
+float PowerRegulator::update(float power, float dt)
+{
+    float error = _targetPower - power;
+
+#ifdef VAWT_POWER_REG_FIXED
+    // Fixed-point core: the accumulate path is integer-only. Error in
+    // Q16.16 saturates far beyond any real power error (+/-32 kW).
+    int32_t errorQ = toQ16(error);
+    int32_t kpQ = toQ16(_kp);
+    int32_t u = _integratorQ16 + (int32_t)(((int64_t)kpQ * errorQ) >> 16);
+
+    int32_t uSat = u;
+    if (uSat > toQ16(DUTY_MAX))
+        uSat = toQ16(DUTY_MAX);
+    if (uSat < toQ16(DUTY_MIN))
+        uSat = toQ16(DUTY_MIN);
+
+    // Clamping anti-windup: hold the integrator while saturated, unless
+    // the error is pulling the output back inside the limits
+    if (u == uSat || (u > uSat && error < 0) || (u < uSat && error > 0))
+    {
+        int32_t kiQ = toQ16(_ki * dt);
+        _integratorQ16 += (int32_t)(((int64_t)kiQ * errorQ) >> 16);
+        if (_integratorQ16 > toQ16(DUTY_MAX))
+            _integratorQ16 = toQ16(DUTY_MAX);
+        if (_integratorQ16 < toQ16(DUTY_MIN))
+            _integratorQ16 = toQ16(DUTY_MIN);
+    }
+    return fromQ16(uSat);
+#else
+    float u = _integrator + _kp * error;
+    float uSat = constrain(u, DUTY_MIN, DUTY_MAX);
+
+    // Clamping anti-windup: hold the integrator while saturated, unless
+    // the error is pulling the output back inside the limits
+    if (u == uSat || (u > uSat && error < 0) || (u < uSat && error > 0))
+    {
+        _integrator += _ki * error * dt;
+        _integrator = constrain(_integrator, DUTY_MIN, DUTY_MAX);
+    }
+    return uSat;
+#endif
+}
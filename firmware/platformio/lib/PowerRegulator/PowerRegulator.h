@@ -0,0 +1,76 @@
+#ifndef POWER_REGULATOR_H
+#define POWER_REGULATOR_H
+
+#include <Arduino.h>
+
+/**
+ * PI power regulator for the POWER_REGULATION (soft-stall) state.
+ *
+ * Replaces the old calculateSoftStall() in main.cpp, whose function-local
+ * integrator wound up without bound while the state machine was in other
+ * states and whose gains implicitly assumed a 1 Hz call rate. Here:
+ *
+ *   - Gains are per-second (duty/W and duty/(W*s)); update() takes dt,
+ *     so the regulator behaves identically at any loop rate.
+ *   - Clamping anti-windup: the integrator only accumulates while the
+ *     output is inside the duty limits, or while the error is driving it
+ *     back inside them.
+ *   - Bumpless transfer: arm() presets the integrator to the duty the
+ *     MPPT was commanding, so crossing into POWER_REGULATION continues
+ *     from the current operating point instead of jumping to a wound-up
+ *     value.
+ *
+ * Build with -DVAWT_POWER_REG_FIXED for a Q16.16 fixed-point integrator
+ * core - same API and behavior, no FPU in the accumulate path, for
+ * running the regulator at higher loop rates or from contexts where the
+ * FPU is unavailable (e.g. ISRs, where the Xtensa FPU is off-limits).
+ */
+class PowerRegulator
+{
+public:
+    /**
+     * @param targetPower Regulation setpoint (W), typically rated power
+     * @param kp Proportional gain (duty per W of error)
+     * @param ki Integral gain (duty per W*s of accumulated error)
+     */
+    PowerRegulator(float targetPower, float kp = 0.01f, float ki = 0.001f);
+
+    void setTarget(float targetPower);
+    void setGains(float kp, float ki);
+
+    /**
+     * Bumpless transfer: call on POWER_REGULATION entry with the duty
+     * currently commanded (usually the last MPPT duty). The first
+     * update() output then starts from that operating point.
+     */
+    void arm(float currentDuty);
+
+    /**
+     * One PI step.
+     * @param power Measured output power (W)
+     * @param dt Seconds since the previous update
+     * @return Duty cycle, clamped to [0.1, 0.9]
+     */
+    float update(float power, float dt);
+
+    /** Back to the neutral operating point (mid-range duty) */
+    void reset();
+
+private:
+    // Same duty limits as the MPPT: 10% keeps a minimum load on the
+    // generator, 90% avoids saturation
+    static constexpr float DUTY_MIN = 0.1f;
+    static constexpr float DUTY_MAX = 0.9f;
+
+    float _targetPower;
+    float _kp;
+    float _ki;
+
+#ifdef VAWT_POWER_REG_FIXED
+    int32_t _integratorQ16; // Duty in Q16.16
+#else
+    float _integrator; // Duty units; doubles as the operating-point bias
+#endif
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "PowerSense.h"
+
+PowerSense::PowerSense()
+    : _address(0x40),
+      _sampleRateHz(100),
+      _running(false),
+      _samplerTaskHandle(NULL),
+      _errorCount(0),
+      _seq(0)
+{
+    _reading.voltage = 0;
+    _reading.current = 0;
+    _reading.power = 0;
+    _reading.timestamp = 0;
+}
+
+bool PowerSense::begin(uint8_t address, uint32_t sampleRateHz)
+{
+    _address = address;
+    _sampleRateHz = sampleRateHz;
+
+    Wire.setClock(400000); // Fast-mode I2C halves time on the bus
+
+    if (!writeRegister(REG_CONFIG, CONFIG_VALUE) ||
+        !writeRegister(REG_CALIBRATION, CALIBRATION_VALUE))
+    {
+        Serial.println("[POWER] INA219 not responding");
+        return false;
+    }
+
+    _running = true;
+
+    // Sampler lives on core 0: it blocks on I2C, never on the control core
+    xTaskCreatePinnedToCore(samplerTaskEntry, "powersense", 2048, this,
+                            4, &_samplerTaskHandle, 0);
+
+    return true;
+}
+
+PowerReading PowerSense::latest() const
+{
+    // Seqlock read: retry if the writer was mid-update (odd) or updated
+    // underneath us. The writer runs at ~100 Hz, so retries are rare and
+    // the loop is bounded in practice to one extra pass.
+    PowerReading copy;
+    uint32_t seqBefore, seqAfter;
+    do
+    {
+        seqBefore = _seq;
+        copy = _reading;
+        seqAfter = _seq;
+    } while ((seqBefore & 1) || seqBefore != seqAfter);
+    return copy;
+}
+
+bool PowerSense::writeRegister(uint8_t reg, uint16_t value)
+{
+    Wire.beginTransmission(_address);
+    Wire.write(reg);
+    Wire.write((uint8_t)(value >> 8));
+    Wire.write((uint8_t)(value & 0xFF));
+    return Wire.endTransmission() == 0;
+}
+
+bool PowerSense::readRegister(uint8_t reg, uint16_t &value)
+{
+    Wire.beginTransmission(_address);
+    Wire.write(reg);
+    if (Wire.endTransmission() != 0)
+        return false;
+
+    if (Wire.requestFrom(_address, (uint8_t)2) != 2)
+        return false;
+
+    value = ((uint16_t)Wire.read() << 8) | Wire.read();
+    return true;
+}
+
+void PowerSense::samplerTaskEntry(void *pvParameters)
+{
+    static_cast<PowerSense *>(pvParameters)->samplerTask();
+}
+
+// Fixed-rate acquisition: bus voltage and current read back-to-back so
+// the published pair comes from the same conversion window, then one
+// seqlock-protected publish.
+void PowerSense::samplerTask()
+{
+    TickType_t lastWakeTime = xTaskGetTickCount();
+    const TickType_t period = pdMS_TO_TICKS(1000 / _sampleRateHz);
+
+    while (_running)
+    {
+        vTaskDelayUntil(&lastWakeTime, period);
+
+        uint16_t rawBus, rawCurrent;
+        if (!readRegister(REG_BUS_VOLTAGE, rawBus) ||
+            !readRegister(REG_CURRENT, rawCurrent))
+        {
+            _errorCount++;
+            continue; // Keep the last good reading published
+        }
+
+        // Bus voltage: bits 15..3, 4 mV per LSB
+        float voltage = (rawBus >> 3) * 0.004f;
+        float current = (int16_t)rawCurrent * CURRENT_LSB_A;
+
+        _seq = _seq + 1; // Odd: update in progress
+        _reading.voltage = voltage;
+        _reading.current = current;
+        _reading.power = voltage * current;
+        _reading.timestamp = millis();
+        _seq = _seq + 1; // Even: coherent
+    }
+
+    vTaskDelete(NULL);
+}
@@ -0,0 +1,80 @@
+#ifndef POWER_SENSE_H
+#define POWER_SENSE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// One coherent acquisition: voltage and current from the same INA219
+// conversion window, not milliseconds apart
+struct PowerReading
+{
+    float voltage;           // Bus voltage (V)
+    float current;           // Bus current (A)
+    float power;             // V * I (W)
+    unsigned long timestamp; // millis() at acquisition
+};
+
+/**
+ * Asynchronous INA219 power measurement.
+ *
+ * A dedicated core-0 task polls the INA219 at a fixed rate over 400 kHz
+ * I2C, reading bus voltage and current back-to-back (the INA219 register
+ * pointer does not auto-increment, so 'one burst' is two short reads in
+ * immediate succession) and publishing the pair as one coherent triple
+ * through a seqlock. The control loop's latest() is a lock-free copy -
+ * no I2C transaction, no possibility of an SDA glitch hanging the
+ * control path, and V/I always from the same conversion window.
+ *
+ * Register-level driver (no Adafruit_INA219 dependency here) configured
+ * like the library's 32V/2A default: cal = 4096, 100 uA/bit.
+ */
+class PowerSense
+{
+public:
+    PowerSense();
+
+    /**
+     * Configure the INA219 and start the sampler task.
+     * @param address I2C address (default 0x40)
+     * @param sampleRateHz Acquisition rate (default 100 Hz)
+     */
+    bool begin(uint8_t address = 0x40, uint32_t sampleRateHz = 100);
+
+    /** Latest coherent (V, I, P) triple. Lock-free, safe from any task. */
+    PowerReading latest() const;
+
+    /** Failed I2C transactions since begin() (link health diagnostic) */
+    uint32_t getErrorCount() const { return _errorCount; }
+
+private:
+    // INA219 registers
+    static const uint8_t REG_CONFIG = 0x00;
+    static const uint8_t REG_BUS_VOLTAGE = 0x02;
+    static const uint8_t REG_CURRENT = 0x04;
+    static const uint8_t REG_CALIBRATION = 0x05;
+
+    // 32V range, ±320 mV shunt, 12-bit continuous shunt+bus
+    static const uint16_t CONFIG_VALUE = 0x399F;
+    // Matches the Adafruit 32V/2A calibration: 100 uA per current LSB
+    static const uint16_t CALIBRATION_VALUE = 4096;
+    static constexpr float CURRENT_LSB_A = 0.0001f;
+
+    uint8_t _address;
+    uint32_t _sampleRateHz;
+    bool _running;
+    TaskHandle_t _samplerTaskHandle;
+    uint32_t _errorCount;
+
+    // Seqlock-published reading: writer bumps _seq to odd, updates, bumps
+    // to even; readers retry while odd or changed
+    volatile uint32_t _seq;
+    PowerReading _reading;
+
+    bool writeRegister(uint8_t reg, uint16_t value);
+    bool readRegister(uint8_t reg, uint16_t &value);
+
+    static void samplerTaskEntry(void *pvParameters);
+    void samplerTask();
+};
+
+#endif
@@ -0,0 +1,71 @@
+#include "LoopProfiler.h"
+
+LoopProfiler::LoopProfiler()
+{
+    reset();
+}
+
+void LoopProfiler::reset()
+{
+    for (int s = 0; s < STAGE_COUNT; s++)
+    {
+        _stats[s].minCycles = UINT32_MAX;
+        _stats[s].maxCycles = 0;
+        _stats[s].sumCycles = 0;
+        _stats[s].count = 0;
+        memset(_stats[s].buckets, 0, sizeof(_stats[s].buckets));
+    }
+}
+
+uint32_t LoopProfiler::p99Cycles(Stage stage) const
+{
+    const StageStats &s = _stats[stage];
+    if (s.count == 0)
+        return 0;
+
+    // Walk buckets from the top until 1% of samples are above; the p99
+    // estimate is that bucket's upper bound
+    uint32_t tailBudget = s.count / 100;
+    uint32_t seen = 0;
+    for (int b = BUCKET_COUNT - 1; b >= 0; b--)
+    {
+        seen += s.buckets[b];
+        if (seen > tailBudget)
+        {
+            return (b >= 31) ? UINT32_MAX : (2UL << b);
+        }
+    }
+    return s.maxCycles;
+}
+
+size_t LoopProfiler::formatStage(Stage stage, unsigned long timestamp,
+                                 char *out, size_t outSize) const
+{
+    const StageStats &s = _stats[stage];
+    uint32_t avg = (s.count > 0) ? (uint32_t)(s.sumCycles / s.count) : 0;
+    uint32_t minC = (s.count > 0) ? s.minCycles : 0;
+
+    return snprintf(out, outSize,
+                    "#PROF,%lu,%s,n=%lu,min=%lu,avg=%lu,max=%lu,p99~%lu\n",
+                    timestamp, stageName(stage),
+                    (unsigned long)s.count, (unsigned long)minC,
+                    (unsigned long)avg, (unsigned long)s.maxCycles,
+                    (unsigned long)p99Cycles(stage));
+}
+
+const char *LoopProfiler::stageName(Stage stage)
+{
+    switch (stage)
+    {
+    case STAGE_SENSORS:
+        return "sensors";
+    case STAGE_SAFETY:
+        return "safety";
+    case STAGE_STATE_MACHINE:
+        return "state_machine";
+    case STAGE_LOGGING:
+        return "logging";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <Arduino.h>
+#include <xtensa/hal.h>
+
+/**
+ * Cycle-accurate per-stage instrumentation for the control loop.
+ *
+ * Wrap each stage of the control tick in a ScopedStageTimer; the
+ * profiler accumulates min/max/sum plus a log2 histogram of CCOUNT
+ * deltas per stage. Recording is a handful of integer ops - cheap enough
+ * to leave enabled in the field, which is the point: when a unit shows
+ * loop overruns, the per-stage p99s logged alongside the turbine data
+ * say whether the time went to sensors, control math or logging.
+ *
+ * formatStage() renders one stage as a '#PROF' comment line for the CSV
+ * log / serial; p99 is estimated from the histogram as the upper bound
+ * of the bucket where the top percentile falls (power-of-two accuracy,
+ * which is plenty for spotting a stage that jumped an order of
+ * magnitude).
+ */
+class LoopProfiler
+{
+public:
+    enum Stage
+    {
+        STAGE_SENSORS,       // Wind/RPM refresh
+        STAGE_SAFETY,        // SafetyMonitor fast path
+        STAGE_STATE_MACHINE, // Bus reads + state logic + MPPT
+        STAGE_LOGGING,       // DataLogger append
+        STAGE_COUNT
+    };
+
+    LoopProfiler();
+
+    /** Record one timed stage execution. Called from the scoped timer. */
+    inline void record(Stage stage, uint32_t cycles)
+    {
+        StageStats &s = _stats[stage];
+        if (cycles < s.minCycles)
+            s.minCycles = cycles;
+        if (cycles > s.maxCycles)
+            s.maxCycles = cycles;
+        s.sumCycles += cycles;
+        s.count++;
+        s.buckets[bucketFor(cycles)]++;
+    }
+
+    /** Approximate p99 cycles for a stage (histogram bucket upper bound) */
+    uint32_t p99Cycles(Stage stage) const;
+
+    /**
+     * Render one stage as a '#PROF' comment line.
+     * @return Number of characters written
+     */
+    size_t formatStage(Stage stage, unsigned long timestamp,
+                       char *out, size_t outSize) const;
+
+    void reset();
+
+    static const char *stageName(Stage stage);
+
+private:
+    static const int BUCKET_COUNT = 32; // log2 buckets over uint32 range
+
+    struct StageStats
+    {
+        uint32_t minCycles;
+        uint32_t maxCycles;
+        uint64_t sumCycles;
+        uint32_t count;
+        uint32_t buckets[BUCKET_COUNT];
+    };
+
+    StageStats _stats[STAGE_COUNT];
+
+    static inline int bucketFor(uint32_t cycles)
+    {
+        return 31 - __builtin_clz(cycles | 1);
+    }
+};
+
+/**
+ * RAII timer: reads CCOUNT on entry and records the delta on scope exit.
+ */
+class ScopedStageTimer
+{
+public:
+    ScopedStageTimer(LoopProfiler &profiler, LoopProfiler::Stage stage)
+        : _profiler(profiler), _stage(stage), _start(xthal_get_ccount())
+    {
+    }
+
+    ~ScopedStageTimer()
+    {
+        _profiler.record(_stage, xthal_get_ccount() - _start);
+    }
+
+private:
+    LoopProfiler &_profiler;
+    LoopProfiler::Stage _stage;
+    uint32_t _start;
+};
+
+#endif
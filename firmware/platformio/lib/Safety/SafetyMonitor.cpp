@@ -7,41 +7,89 @@ SafetyMonitor::SafetyMonitor(float overspeedRPM, float overvoltage)
       _overspeedFlag(false),
       _overvoltageFlag(false),
       _overcurrentFlag(false),
-      _lastCheckTime(0)
+      _lastCheckTime(0),
+      _eventHead(0),
+      _eventTail(0),
+      _droppedEvents(0)
 {
 }
 
+// Fast path: three compares and, on a rising violation edge, one queued
+// event record. Nothing here blocks - Serial reporting happens in
+// reportEvents() on the I/O task.
 bool SafetyMonitor::check(float rpm, float voltage, float current)
 {
     _lastCheckTime = millis();
 
     // Check overspeed
-    _overspeedFlag = (rpm > _overspeedThreshold);
-    if (_overspeedFlag)
+    bool overspeed = (rpm > _overspeedThreshold);
+    if (overspeed && !_overspeedFlag)
     {
-        Serial.printf("[SAFETY] OVERSPEED: %.0f RPM (limit: %.0f)\n",
-                      rpm, _overspeedThreshold);
+        queueEvent(SAFETY_EVENT_OVERSPEED, rpm, _overspeedThreshold);
     }
+    _overspeedFlag = overspeed;
 
     // Check overvoltage
-    _overvoltageFlag = (voltage > _overvoltageThreshold);
-    if (_overvoltageFlag)
+    bool overvoltage = (voltage > _overvoltageThreshold);
+    if (overvoltage && !_overvoltageFlag)
     {
-        Serial.printf("[SAFETY] OVERVOLTAGE: %.1f V (limit: %.1f)\n",
-                      voltage, _overvoltageThreshold);
+        queueEvent(SAFETY_EVENT_OVERVOLTAGE, voltage, _overvoltageThreshold);
     }
+    _overvoltageFlag = overvoltage;
 
     // Check overcurrent
-    _overcurrentFlag = (current > _overcurrentThreshold);
-    if (_overcurrentFlag)
+    bool overcurrent = (current > _overcurrentThreshold);
+    if (overcurrent && !_overcurrentFlag)
     {
-        Serial.printf("[SAFETY] OVERCURRENT: %.1f A (limit: %.1f)\n",
-                      current, _overcurrentThreshold);
+        queueEvent(SAFETY_EVENT_OVERCURRENT, current, _overcurrentThreshold);
     }
+    _overcurrentFlag = overcurrent;
 
     return !(_overspeedFlag || _overvoltageFlag || _overcurrentFlag);
 }
 
+void SafetyMonitor::queueEvent(uint8_t type, float value, float limit)
+{
+    if (_eventHead - _eventTail >= EVENT_QUEUE_SIZE)
+    {
+        _droppedEvents++; // Consumer stalled - never block detection
+        return;
+    }
+
+    SafetyEvent &event = _events[_eventHead % EVENT_QUEUE_SIZE];
+    event.timestamp = _lastCheckTime;
+    event.type = type;
+    event.value = value;
+    event.limit = limit;
+    _eventHead = _eventHead + 1; // Publish after the record is complete
+}
+
+// Slow path: report queued violations over Serial. Runs on the I/O task,
+// so serial latency never delays detection or the brake.
+void SafetyMonitor::reportEvents()
+{
+    while (_eventTail != _eventHead)
+    {
+        const SafetyEvent &event = _events[_eventTail % EVENT_QUEUE_SIZE];
+        switch (event.type)
+        {
+        case SAFETY_EVENT_OVERSPEED:
+            Serial.printf("[SAFETY] t=%lu OVERSPEED: %.0f RPM (limit: %.0f)\n",
+                          event.timestamp, event.value, event.limit);
+            break;
+        case SAFETY_EVENT_OVERVOLTAGE:
+            Serial.printf("[SAFETY] t=%lu OVERVOLTAGE: %.1f V (limit: %.1f)\n",
+                          event.timestamp, event.value, event.limit);
+            break;
+        case SAFETY_EVENT_OVERCURRENT:
+            Serial.printf("[SAFETY] t=%lu OVERCURRENT: %.1f A (limit: %.1f)\n",
+                          event.timestamp, event.value, event.limit);
+            break;
+        }
+        _eventTail = _eventTail + 1;
+    }
+}
+
 void SafetyMonitor::reset()
 {
     _overspeedFlag = false;
@@ -3,6 +3,37 @@
 
 #include <Arduino.h>
 
+// Safety violation categories
+enum SafetyEventType
+{
+    SAFETY_EVENT_OVERSPEED,
+    SAFETY_EVENT_OVERVOLTAGE,
+    SAFETY_EVENT_OVERCURRENT
+};
+
+// One detected limit violation, queued by the fast path and reported by
+// the I/O task
+struct SafetyEvent
+{
+    unsigned long timestamp; // millis() at detection
+    uint8_t type;            // SafetyEventType
+    float value;             // Measured value that tripped the limit
+    float limit;             // The limit it tripped
+};
+
+/**
+ * Split-path safety supervision:
+ *
+ *   check()        - fast path. Pure threshold compares plus a queued
+ *                    event record on each new violation edge; no Serial,
+ *                    no blocking. Runs every control tick (100 Hz) so
+ *                    worst-case detection latency is one tick.
+ *   reportEvents() - slow path. Drains the event queue to Serial from
+ *                    the I/O task, off the detection path entirely.
+ *
+ * The event ring is single-producer (control task) / single-consumer
+ * (I/O task) with volatile 32-bit indices - no locks on either side.
+ */
 class SafetyMonitor
 {
 public:
@@ -16,7 +47,15 @@ public:
 
     void reset();
 
+    /** Drain queued safety events to Serial. Call from the I/O task. */
+    void reportEvents();
+
+    /** Events lost because the queue was full (consumer stalled) */
+    uint32_t getDroppedEvents() const { return _droppedEvents; }
+
 private:
+    static const uint32_t EVENT_QUEUE_SIZE = 8; // Power of two (index masking)
+
     float _overspeedThreshold;
     float _overvoltageThreshold;
     float _overcurrentThreshold;
@@ -26,6 +65,14 @@ private:
     bool _overcurrentFlag;
 
     unsigned long _lastCheckTime;
+
+    // SPSC event ring: producer bumps _eventHead, consumer bumps _eventTail
+    SafetyEvent _events[EVENT_QUEUE_SIZE];
+    volatile uint32_t _eventHead;
+    volatile uint32_t _eventTail;
+    uint32_t _droppedEvents;
+
+    void queueEvent(uint8_t type, float value, float limit);
 };
 
 #endif
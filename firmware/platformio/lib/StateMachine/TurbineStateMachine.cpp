@@ -1,30 +1,177 @@
 #include "TurbineStateMachine.h"
 
+// Heap-allocating string types are banned in this translation unit: the
+// state-name path runs once per logged sample for months, and per-sample
+// heap churn fragments the allocator
+#pragma GCC poison String
+
+// The single state-name table, indexed by TurbineState. Static storage:
+// callers get stable pointers and the lookup never touches the heap.
+static const char *const STATE_NAMES[] = {
+    "IDLE",      // STATE_IDLE
+    "STANDBY",   // STATE_STANDBY
+    "STARTUP",   // STATE_STARTUP
+    "MPPT",      // STATE_MPPT
+    "POWER_REG", // STATE_POWER_REGULATION
+    "STALL",     // STATE_STALL
+    "FAULT"      // STATE_FAULT
+};
+
+static const int STATE_COUNT = sizeof(STATE_NAMES) / sizeof(STATE_NAMES[0]);
+
+static const char *const EVENT_NAMES[EVENT_COUNT] = {
+    "WIND_ABOVE_CUTIN", // EVENT_WIND_ABOVE_CUTIN
+    "HIGH_WIND",        // EVENT_HIGH_WIND
+    "GUST_PREDICTED",   // EVENT_GUST_PREDICTED
+    "RATED_POWER",      // EVENT_RATED_POWER
+    "POWER_DROPPED",    // EVENT_POWER_DROPPED
+    "ROTOR_SLOWED",     // EVENT_ROTOR_SLOWED
+    "FAULT"             // EVENT_FAULT
+};
+
+const char *turbineStateName(TurbineState state)
+{
+    if (state < 0 || state >= STATE_COUNT)
+    {
+        return "UNKNOWN";
+    }
+    return STATE_NAMES[state];
+}
+
+const char *turbineEventName(TurbineEvent event)
+{
+    if (event < 0 || event >= EVENT_COUNT)
+    {
+        return "UNKNOWN";
+    }
+    return EVENT_NAMES[event];
+}
+
+// --- Transition table ---------------------------------------------------
+
+// Guards: extra conditions checked when a row's event arrives
+static bool guardSafe(const TurbineContext &ctx)
+{
+    return ctx.safe;
+}
+
+// Turbine operating policy as data. Adding a state (STARTUP and IDLE are
+// still unimplemented) means adding rows here, not growing a switch on
+// the control path. There is deliberately no row out of STATE_FAULT:
+// leaving FAULT requires an explicit reset via setState().
+static const TurbineTransition TRANSITIONS[] = {
+    {STATE_STANDBY, EVENT_WIND_ABOVE_CUTIN, guardSafe, NULL, STATE_MPPT},
+    {STATE_MPPT, EVENT_RATED_POWER, NULL, NULL, STATE_POWER_REGULATION},
+    {STATE_MPPT, EVENT_HIGH_WIND, NULL, NULL, STATE_STALL},
+    {STATE_POWER_REGULATION, EVENT_POWER_DROPPED, NULL, NULL, STATE_MPPT},
+    {STATE_POWER_REGULATION, EVENT_HIGH_WIND, NULL, NULL, STATE_STALL},
+
+    // Predictive stall: the spectral gust-onset indicator fires 1-2 s
+    // before the raw wind speed crosses the stall threshold
+    {STATE_MPPT, EVENT_GUST_PREDICTED, NULL, NULL, STATE_STALL},
+    {STATE_POWER_REGULATION, EVENT_GUST_PREDICTED, NULL, NULL, STATE_STALL},
+    {STATE_STALL, EVENT_ROTOR_SLOWED, NULL, NULL, STATE_STANDBY},
+
+    // Any operating state faults out; repeated EVENT_FAULT posts while
+    // already in FAULT find no row and are no-ops
+    {STATE_IDLE, EVENT_FAULT, NULL, NULL, STATE_FAULT},
+    {STATE_STANDBY, EVENT_FAULT, NULL, NULL, STATE_FAULT},
+    {STATE_STARTUP, EVENT_FAULT, NULL, NULL, STATE_FAULT},
+    {STATE_MPPT, EVENT_FAULT, NULL, NULL, STATE_FAULT},
+    {STATE_POWER_REGULATION, EVENT_FAULT, NULL, NULL, STATE_FAULT},
+    {STATE_STALL, EVENT_FAULT, NULL, NULL, STATE_FAULT},
+};
+
+static const int TRANSITION_COUNT =
+    sizeof(TRANSITIONS) / sizeof(TRANSITIONS[0]);
+
+// Dispatch index: [state][event] -> row in TRANSITIONS, or -1. Built
+// once at construction, so postEvent() is one 2D array read regardless
+// of table size.
+static int8_t transitionIndex[STATE_COUNT][EVENT_COUNT];
+static bool transitionIndexBuilt = false;
+
+static void buildTransitionIndex()
+{
+    for (int s = 0; s < STATE_COUNT; s++)
+    {
+        for (int e = 0; e < EVENT_COUNT; e++)
+        {
+            transitionIndex[s][e] = -1;
+        }
+    }
+    for (int i = 0; i < TRANSITION_COUNT; i++)
+    {
+        transitionIndex[TRANSITIONS[i].from][TRANSITIONS[i].event] = (int8_t)i;
+    }
+    transitionIndexBuilt = true;
+}
+
+// --- State machine ------------------------------------------------------
+
 TurbineStateMachine::TurbineStateMachine()
     : _currentState(STATE_IDLE),
       _previousState(STATE_IDLE),
-      _stateEntryTime(0)
+      _stateEntryTime(0),
+      _notifyHead(0),
+      _notifyTail(0),
+      _droppedNotifications(0)
 {
+    if (!transitionIndexBuilt) // Constructed before the scheduler starts
+    {
+        buildTransitionIndex();
+    }
 }
 
-void TurbineStateMachine::setState(TurbineState newState)
+bool TurbineStateMachine::postEvent(TurbineEvent event, const TurbineContext &ctx)
 {
-    if (newState != _currentState)
+    if (event < 0 || event >= EVENT_COUNT)
+    {
+        return false;
+    }
+
+    int8_t row = transitionIndex[_currentState][event];
+    if (row < 0)
     {
-        onStateExit();
+        return false; // Event is irrelevant in this state
+    }
 
-        _previousState = _currentState;
-        _currentState = newState;
-        _stateEntryTime = millis();
+    const TurbineTransition &t = TRANSITIONS[row];
+    if (t.guard != NULL && !t.guard(ctx))
+    {
+        return false;
+    }
+    if (t.action != NULL)
+    {
+        t.action(ctx);
+    }
 
-        onStateEntry();
+    transitionTo(t.to, (int8_t)event);
+    return true;
+}
 
-        Serial.printf("[STATE] %s -> %s\n",
-                      getStateName(),
-                      getStateName());
+// Direct transition, bypassing the table - used for initialization and
+// explicit fault reset. Notified with event = -1.
+void TurbineStateMachine::setState(TurbineState newState)
+{
+    if (newState != _currentState)
+    {
+        transitionTo(newState, -1);
     }
 }
 
+// Shared transition core: swap states, stamp the entry time, queue the
+// notification. Nothing here blocks - entry/exit reporting happens on
+// the I/O task via reportTransitions().
+void TurbineStateMachine::transitionTo(TurbineState newState, int8_t event)
+{
+    _previousState = _currentState;
+    _currentState = newState;
+    _stateEntryTime = millis();
+
+    queueNotification(_previousState, _currentState, event);
+}
+
 TurbineState TurbineStateMachine::getState() const
 {
     return _currentState;
@@ -32,25 +179,7 @@ TurbineState TurbineStateMachine::getState() const
 
 const char *TurbineStateMachine::getStateName() const
 {
-    switch (_currentState)
-    {
-    case STATE_IDLE:
-        return "IDLE";
-    case STATE_STANDBY:
-        return "STANDBY";
-    case STATE_STARTUP:
-        return "STARTUP";
-    case STATE_MPPT:
-        return "MPPT";
-    case STATE_POWER_REGULATION:
-        return "POWER_REG";
-    case STATE_STALL:
-        return "STALL";
-    case STATE_FAULT:
-        return "FAULT";
-    default:
-        return "UNKNOWN";
-    }
+    return turbineStateName(_currentState);
 }
 
 unsigned long TurbineStateMachine::getTimeInState() const
@@ -58,6 +187,57 @@ unsigned long TurbineStateMachine::getTimeInState() const
     return millis() - _stateEntryTime;
 }
 
+void TurbineStateMachine::queueNotification(TurbineState from,
+                                            TurbineState to, int8_t event)
+{
+    uint32_t head = _notifyHead;
+    if (head - _notifyTail >= NOTIFY_QUEUE_SIZE)
+    {
+        // Consumer stalled; drop rather than block the control path
+        _droppedNotifications++;
+        return;
+    }
+
+    StateNotification &n = _notifications[head % NOTIFY_QUEUE_SIZE];
+    n.timestamp = millis();
+    n.from = from;
+    n.to = to;
+    n.event = event;
+    _notifyHead = head + 1; // Publish after the slot is written
+}
+
+// Slow path: print queued transitions from the I/O task. A STALL ->
+// STANDBY -> MPPT flap costs the control path three ring writes, not six
+// blocking Serial calls.
+void TurbineStateMachine::reportTransitions()
+{
+    while (_notifyTail != _notifyHead)
+    {
+        const StateNotification &n = _notifications[_notifyTail % NOTIFY_QUEUE_SIZE];
+        if (n.event >= 0)
+        {
+            Serial.printf("[STATE] t=%lu %s -> %s on %s\n",
+                          n.timestamp, turbineStateName(n.from),
+                          turbineStateName(n.to),
+                          turbineEventName((TurbineEvent)n.event));
+        }
+        else
+        {
+            Serial.printf("[STATE] t=%lu %s -> %s (direct)\n",
+                          n.timestamp, turbineStateName(n.from),
+                          turbineStateName(n.to));
+        }
+        _notifyTail = _notifyTail + 1;
+    }
+
+    if (_droppedNotifications > 0)
+    {
+        Serial.printf("[STATE] %lu notifications dropped (queue full)\n",
+                      (unsigned long)_droppedNotifications);
+        _droppedNotifications = 0;
+    }
+}
+
 void TurbineStateMachine::logTransition(const char *reason)
 {
     _lastTransition.timestamp = millis();
@@ -71,59 +251,3 @@ TurbineStateMachine::StateTransition TurbineStateMachine::getLastTransition() co
 {
     return _lastTransition;
 }
-
-void TurbineStateMachine::onStateEntry()
-{
-    // Perform state-specific initialization
-    switch (_currentState)
-    {
-    case STATE_IDLE:
-        Serial.println("[STATE] Entering IDLE - System check");
-        break;
-    case STATE_STANDBY:
-        Serial.println("[STATE] Entering STANDBY - Waiting for wind");
-        break;
-    case STATE_MPPT:
-        Serial.println("[STATE] Entering MPPT - Optimizing power");
-        break;
-    case STATE_POWER_REGULATION:
-        Serial.println("[STATE] Entering POWER_REG - Limiting output");
-        break;
-    case STATE_STALL:
-        Serial.println("[STATE] Entering STALL - High wind protection");
-        break;
-    case STATE_FAULT:
-        Serial.println("[STATE] Entering FAULT - Safe shutdown");
-        break;
-    default:
-        break;
-    }
-}
-
-void TurbineStateMachine::onStateExit()
-{
-    // Cleanup before leaving state
-    switch (_currentState)
-    {
-    case STATE_IDLE:
-        Serial.println("[STATE] Exiting IDLE");
-        break;
-    case STATE_STANDBY:
-        Serial.println("[STATE] Exiting STANDBY");
-        break;
-    case STATE_MPPT:
-        Serial.println("[STATE] Exiting MPPT");
-        break;
-    case STATE_POWER_REGULATION:
-        Serial.println("[STATE] Exiting POWER_REG");
-        break;
-    case STATE_STALL:
-        Serial.println("[STATE] Exiting STALL");
-        break;
-    case STATE_FAULT:
-        Serial.println("[STATE] Exiting FAULT");
-        break;
-    default:
-        break;
-    }
-}
\ No newline at end of file
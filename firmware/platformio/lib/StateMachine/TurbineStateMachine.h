@@ -15,16 +15,102 @@ enum TurbineState
     STATE_FAULT             // Error condition, safe shutdown
 };
 
+// Observations posted by sensor/safety code. The transition table
+// decides which of them matter in the current state, so posting an
+// irrelevant event is a cheap no-op.
+enum TurbineEvent
+{
+    EVENT_WIND_ABOVE_CUTIN, // Wind above cut-in speed
+    EVENT_HIGH_WIND,        // Wind above the stall-protection speed
+    EVENT_GUST_PREDICTED,   // Spectral gust-onset indicator fired
+    EVENT_RATED_POWER,      // Output at/above the rated-power band
+    EVENT_POWER_DROPPED,    // Output back below the regulation band
+    EVENT_ROTOR_SLOWED,     // Rotor below rated RPM
+    EVENT_FAULT,            // Safety limit violated
+    EVENT_COUNT
+};
+
+// Name of a state as a static string - the one table shared by the state
+// machine, the logger and any debug output. Never allocates; returns
+// "UNKNOWN" for out-of-range values.
+const char *turbineStateName(TurbineState state);
+
+// Event name from the matching static table
+const char *turbineEventName(TurbineEvent event);
+
+// Sensor snapshot handed to transition guards with each posted event
+struct TurbineContext
+{
+    float windSpeed;
+    float rpm;
+    float power;
+    bool safe;
+};
+
+// Guard: extra condition a transition row checks beyond its event.
+// Action: side effect run when the row fires. Both may be NULL. Hardware
+// outputs (PWM, relays) stay with the pin owners in main.cpp's per-state
+// handlers; actions are for bookkeeping that belongs to the transition.
+typedef bool (*TransitionGuard)(const TurbineContext &ctx);
+typedef void (*TransitionAction)(const TurbineContext &ctx);
+
+// One row of the static transition table
+struct TurbineTransition
+{
+    TurbineState from;
+    TurbineEvent event;
+    TransitionGuard guard;
+    TransitionAction action;
+    TurbineState to;
+};
+
+/**
+ * Table-driven state machine with queued transition notifications:
+ *
+ *   postEvent()         - fast path. Dispatch is one [state][event]
+ *                         array lookup into the static transition table;
+ *                         if a row exists and its guard passes, the
+ *                         transition runs and a notification is queued.
+ *                         No Serial, no allocation, constant time no
+ *                         matter how many states/rows are added.
+ *   reportTransitions() - slow path. Drains queued notifications to
+ *                         Serial from the I/O task.
+ *
+ * The notification ring is single-producer (control task) / single-
+ * consumer (I/O task) with volatile 32-bit indices - same pattern as
+ * SafetyMonitor's event queue.
+ */
 class TurbineStateMachine
 {
 public:
     TurbineStateMachine();
 
+    /**
+     * Post an observed event against the transition table.
+     * @return true if a transition fired
+     */
+    bool postEvent(TurbineEvent event, const TurbineContext &ctx);
+
     void setState(TurbineState newState);
     TurbineState getState() const;
     const char *getStateName() const;
     unsigned long getTimeInState() const;
 
+    // One queued entry/exit notification
+    struct StateNotification
+    {
+        unsigned long timestamp;
+        TurbineState from;
+        TurbineState to;
+        int8_t event; // TurbineEvent, or -1 for a direct setState()
+    };
+
+    /** Drain queued transition notifications to Serial (I/O task). */
+    void reportTransitions();
+
+    /** Notifications lost because the queue was full */
+    uint32_t getDroppedNotifications() const { return _droppedNotifications; }
+
     // State transition logging
     struct StateTransition
     {
@@ -38,13 +124,22 @@ public:
     StateTransition getLastTransition() const;
 
 private:
+    static const uint32_t NOTIFY_QUEUE_SIZE = 8; // Power of two (index masking)
+
     TurbineState _currentState;
     TurbineState _previousState;
     unsigned long _stateEntryTime;
     StateTransition _lastTransition;
 
-    void onStateEntry();
-    void onStateExit();
+    // SPSC notification ring: producer bumps _notifyHead, consumer
+    // bumps _notifyTail
+    StateNotification _notifications[NOTIFY_QUEUE_SIZE];
+    volatile uint32_t _notifyHead;
+    volatile uint32_t _notifyTail;
+    uint32_t _droppedNotifications;
+
+    void transitionTo(TurbineState newState, int8_t event);
+    void queueNotification(TurbineState from, TurbineState to, int8_t event);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,140 @@
+#include "TachometerInput.h"
+
+TachometerInput::TachometerInput()
+    : _unit(PCNT_UNIT_0),
+      _pulsesPerRev(1),
+      _initialized(false),
+      _havePulseRef(false),
+      _pulseRefMicros(0),
+      _lastPulseSeen(0),
+      _ringIndex(0),
+      _ringCount(0),
+      _lastRawRPM(0)
+{
+    for (int i = 0; i < RING_SIZE; i++)
+    {
+        _rpmRing[i] = 0;
+    }
+}
+
+bool TachometerInput::begin(uint8_t pin, uint8_t pulsesPerRev, pcnt_unit_t unit)
+{
+    _unit = unit;
+    _pulsesPerRev = pulsesPerRev;
+
+    pcnt_config_t config = {};
+    config.pulse_gpio_num = pin;
+    config.ctrl_gpio_num = PCNT_PIN_NOT_USED;
+    config.channel = PCNT_CHANNEL_0;
+    config.unit = _unit;
+    config.pos_mode = PCNT_COUNT_DIS;  // Count falling edges only,
+    config.neg_mode = PCNT_COUNT_INC;  // matching the old FALLING ISR
+    config.lctrl_mode = PCNT_MODE_KEEP;
+    config.hctrl_mode = PCNT_MODE_KEEP;
+    config.counter_h_lim = 32767;
+    config.counter_l_lim = 0;
+
+    if (pcnt_unit_config(&config) != ESP_OK)
+    {
+        Serial.println("[TACH] PCNT unit configuration failed");
+        return false;
+    }
+
+    // Hardware glitch filter: pulses shorter than ~12.8 us (contact
+    // bounce, EMI spikes) never reach the counter
+    pcnt_set_filter_value(_unit, GLITCH_FILTER_APB_CYCLES);
+    pcnt_filter_enable(_unit);
+
+    pcnt_counter_pause(_unit);
+    pcnt_counter_clear(_unit);
+    pcnt_counter_resume(_unit);
+
+    _havePulseRef = false;
+    _lastPulseSeen = millis();
+    _initialized = true;
+    return true;
+}
+
+void TachometerInput::update()
+{
+    if (!_initialized)
+        return;
+
+    int16_t count = 0;
+    pcnt_get_counter_value(_unit, &count);
+
+    if (count == 0)
+    {
+        // No pulses yet: at low RPM less than one revolution has
+        // elapsed, and the period keeps accumulating against the
+        // reference - this is what keeps the estimate honest at one
+        // pulse per revolution. Decay to zero once the rotor has
+        // clearly stopped.
+        if (millis() - _lastPulseSeen <= STOP_TIMEOUT_MS)
+        {
+            return;
+        }
+        _lastRawRPM = 0;
+    }
+    else
+    {
+        unsigned long now = micros();
+        pcnt_counter_clear(_unit);
+        _lastPulseSeen = millis();
+
+        if (!_havePulseRef || now - _pulseRefMicros > MAX_SPAN_US)
+        {
+            // First pulses since init, or after a gap long enough to
+            // risk micros() wrap: establish the reference, measure from
+            // the next pulses on
+            _havePulseRef = true;
+            _pulseRefMicros = now;
+            return;
+        }
+
+        // The span since the previous pulse-bearing read covers exactly
+        // the counted pulses, so period resolution is one call interval
+        // (10 ms at tick rate) rather than a whole counting window - at
+        // 1 pulse/rev a fixed 100 ms window would read 0 or 1 pulses
+        // and quantize every spin to 600 RPM
+        float periodUs = (float)(now - _pulseRefMicros) / count;
+        _lastRawRPM = 60000000.0f / (periodUs * _pulsesPerRev);
+        _pulseRefMicros = now;
+    }
+
+    _rpmRing[_ringIndex] = _lastRawRPM;
+    _ringIndex = (_ringIndex + 1) % RING_SIZE;
+    if (_ringCount < RING_SIZE)
+        _ringCount++;
+}
+
+float TachometerInput::getRPM() const
+{
+    if (_ringCount == 0)
+        return 0;
+
+    // Median of the filled portion of the ring: a single wild window
+    // (noise burst that beat the glitch filter) cannot dominate
+    float sorted[RING_SIZE];
+    for (int i = 0; i < _ringCount; i++)
+    {
+        sorted[i] = _rpmRing[i];
+    }
+    for (int i = 1; i < _ringCount; i++) // Insertion sort, N <= 5
+    {
+        float key = sorted[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > key)
+        {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = key;
+    }
+    return sorted[_ringCount / 2];
+}
+
+float TachometerInput::getRawRPM() const
+{
+    return _lastRawRPM;
+}
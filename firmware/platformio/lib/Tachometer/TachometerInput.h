@@ -0,0 +1,72 @@
+#ifndef TACHOMETER_INPUT_H
+#define TACHOMETER_INPUT_H
+
+#include <Arduino.h>
+#include <driver/pcnt.h>
+
+/**
+ * Hardware RPM measurement using the ESP32 PCNT pulse counter.
+ *
+ * The PCNT unit counts rotor pulses in hardware with its glitch filter
+ * rejecting contact bounce, so no ISR runs on the hot path at all. With
+ * one pulse per revolution this rotor delivers at most ~5 Hz, so a
+ * fixed counting window sees 0 or 1 pulses and quantizes the frequency
+ * hopelessly. Instead, update() measures the pulse period: the counter
+ * is cleared only on reads that actually saw pulses, and the elapsed
+ * time between two such reads spans exactly the counted pulses. Called
+ * every 10 ms control tick, the period resolves to one call interval -
+ * a few percent at operating speed - and each measurement lands in a
+ * small ring whose median getRPM() returns, so a single corrupted
+ * reading cannot trip the overspeed check.
+ */
+class TachometerInput
+{
+public:
+    TachometerInput();
+
+    /**
+     * Configure the PCNT unit and start counting.
+     * @param pin GPIO carrying the tachometer pulses
+     * @param pulsesPerRev Pulses per rotor revolution (magnets/vanes)
+     * @param unit PCNT unit to use (default PCNT_UNIT_0)
+     */
+    bool begin(uint8_t pin, uint8_t pulsesPerRev = 1,
+               pcnt_unit_t unit = PCNT_UNIT_0);
+
+    /**
+     * Sample the counter: when pulses have arrived, fold the period
+     * since the previous pulse-bearing read into the median ring. Call
+     * once per control tick - the call rate sets the period resolution.
+     */
+    void update();
+
+    /**
+     * Median-filtered rotor speed over the recent windows.
+     * @return RPM, 0 if no pulses seen recently
+     */
+    float getRPM() const;
+
+    /** Raw (unfiltered) RPM from the most recent window, for diagnostics */
+    float getRawRPM() const;
+
+private:
+    static const int RING_SIZE = 5;      // Measurements in the median filter
+    static const uint16_t GLITCH_FILTER_APB_CYCLES = 1023; // ~12.8 us
+    static const unsigned long STOP_TIMEOUT_MS = 3000; // No pulses -> RPM 0
+    static const unsigned long MAX_SPAN_US = 60000000; // Re-reference beyond
+
+    pcnt_unit_t _unit;
+    uint8_t _pulsesPerRev;
+    bool _initialized;
+
+    bool _havePulseRef;                  // _pulseRefMicros is valid
+    unsigned long _pulseRefMicros;       // micros() of last pulse-bearing read
+    unsigned long _lastPulseSeen;        // millis() of last pulse-bearing read
+
+    float _rpmRing[RING_SIZE];           // Recent per-window RPM values
+    int _ringIndex;
+    int _ringCount;
+    float _lastRawRPM;
+};
+
+#endif
@@ -0,0 +1,150 @@
+#include "TelemetryClient.h"
+
+// Task parameters: core 0 with the other I/O work, below the ioTask
+// priority - telemetry is the first thing to yield when the card is busy
+static const BaseType_t TELEMETRY_TASK_CORE = 0;
+static const uint32_t TELEMETRY_TASK_STACK = 4096;
+static const UBaseType_t TELEMETRY_TASK_PRIORITY = 1;
+static const uint32_t TELEMETRY_POLL_MS = 250;
+
+TelemetryClient::TelemetryClient()
+    : _ssid(NULL),
+      _password(NULL),
+      _host(NULL),
+      _port(0),
+      _head(0),
+      _tail(0),
+      _droppedRecords(0),
+      _seq(0),
+      _sentBatches(0),
+      _sendFailures(0),
+      _backoffMs(BACKOFF_MIN_MS),
+      _nextAttempt(0),
+      _lastSend(0)
+{
+}
+
+bool TelemetryClient::begin(const char *ssid, const char *password,
+                            const char *host, uint16_t port)
+{
+    _ssid = ssid;
+    _password = password;
+    _host = host;
+    _port = port;
+
+    TaskHandle_t handle = NULL;
+    BaseType_t ok = xTaskCreatePinnedToCore(taskEntry, "telemetry",
+                                            TELEMETRY_TASK_STACK, this,
+                                            TELEMETRY_TASK_PRIORITY,
+                                            &handle, TELEMETRY_TASK_CORE);
+    return ok == pdPASS;
+}
+
+// Producer side (control task). Same discipline as DataLogger::log():
+// one slot write plus one volatile index store, no locks, drop-and-count
+// when the consumer has fallen RING_SIZE behind.
+void TelemetryClient::offer(const LogRecord &record)
+{
+    uint32_t head = _head;
+    if (head - _tail >= RING_SIZE)
+    {
+        _droppedRecords++;
+        return;
+    }
+    _ring[head % RING_SIZE] = record;
+    _head = head + 1; // Publish after the slot is written
+}
+
+void TelemetryClient::taskEntry(void *arg)
+{
+    static_cast<TelemetryClient *>(arg)->taskLoop();
+}
+
+void TelemetryClient::taskLoop()
+{
+    for (;;)
+    {
+        serviceLink();
+
+        if (WiFi.status() == WL_CONNECTED && millis() >= _nextAttempt)
+        {
+            uint32_t backlog = pending();
+            bool staleBatch = (backlog > 0 &&
+                               millis() - _lastSend >= MAX_BATCH_AGE_MS);
+
+            if (backlog >= BATCH_SIZE || staleBatch)
+            {
+                uint8_t count = (backlog > BATCH_SIZE)
+                                    ? BATCH_SIZE
+                                    : (uint8_t)backlog;
+                if (sendBatch(count))
+                {
+                    _tail += count; // Consume only after a good send
+                    _sentBatches++;
+                    _lastSend = millis();
+                    _backoffMs = BACKOFF_MIN_MS;
+                }
+                else
+                {
+                    // Records stay in the ring; retry after backoff
+                    _sendFailures++;
+                    _nextAttempt = millis() + _backoffMs;
+                    _backoffMs = min(_backoffMs * 2, BACKOFF_MAX_MS);
+                }
+            }
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(TELEMETRY_POLL_MS));
+    }
+}
+
+// Keep the WiFi association alive, with doubling backoff between
+// attempts so a dead AP costs a few connect frames per five minutes, not
+// a reconnect storm
+void TelemetryClient::serviceLink()
+{
+    if (WiFi.status() == WL_CONNECTED)
+    {
+        return;
+    }
+    if (millis() < _nextAttempt)
+    {
+        return;
+    }
+
+    Serial.printf("[TELEM] Connecting to %s\n", _ssid);
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(_ssid, _password);
+
+    _nextAttempt = millis() + _backoffMs;
+    _backoffMs = min(_backoffMs * 2, BACKOFF_MAX_MS);
+}
+
+// One datagram: header + count packed records, peeked from the ring
+// without consuming (the caller advances _tail on success)
+bool TelemetryClient::sendBatch(uint8_t count)
+{
+    PacketHeader header;
+    header.magic = PACKET_MAGIC;
+    header.seq = _seq;
+    header.count = count;
+    header.version = PROTOCOL_VERSION;
+
+    if (_udp.beginPacket(_host, _port) != 1)
+    {
+        return false;
+    }
+    _udp.write((const uint8_t *)&header, sizeof(header));
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const LogRecord &rec = _ring[(_tail + i) % RING_SIZE];
+        _udp.write((const uint8_t *)&rec, sizeof(rec));
+    }
+    if (_udp.endPacket() != 1)
+    {
+        return false;
+    }
+
+    _seq++;
+    return true;
+}
@@ -0,0 +1,101 @@
+#ifndef TELEMETRY_CLIENT_H
+#define TELEMETRY_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include "DataLogger.h" // LogRecord - the same record the SD stream uses
+
+/**
+ * Batched binary telemetry uplink (core-0 task).
+ *
+ * The control task offers it the same packed LogRecords the SD logger
+ * gets; a low-priority task on core 0 batches BATCH_SIZE of them into a
+ * single binary UDP datagram and transmits - one radio wakeup and one
+ * packet per ~30 samples instead of per-sample publishes, which is what
+ * a metered backhaul and the radio duty cycle care about. The site
+ * gateway republishes datagrams onto MQTT; framing below is
+ * self-describing so the gateway needs no firmware-version knowledge.
+ *
+ *   offer()   - producer side (control task). Lock-free SPSC ring write,
+ *               bounded time; drops and counts when the ring is full.
+ *   the task  - consumer side. Maintains the WiFi link with exponential
+ *               backoff, peeks a batch, sends it, and only consumes the
+ *               records after a successful send - so a link outage
+ *               buffers up to RING_SIZE samples instead of losing them,
+ *               and everything always still lands on SD via DataLogger
+ *               regardless.
+ *
+ * Datagram layout (little-endian):
+ *   uint32 magic 'VWT1' | uint16 seq | uint8 count | uint8 version
+ *   followed by count * sizeof(LogRecord) packed records.
+ */
+class TelemetryClient
+{
+public:
+    TelemetryClient();
+
+    /**
+     * Connect credentials + collector endpoint and start the uplink
+     * task on core 0. Returns false if the task could not start; the
+     * WiFi link itself comes and goes and is handled internally.
+     */
+    bool begin(const char *ssid, const char *password,
+               const char *host, uint16_t port);
+
+    /** Producer side (control task) - bounded time, never blocks */
+    void offer(const LogRecord &record);
+
+    uint32_t getSentBatches() const { return _sentBatches; }
+    uint32_t getSendFailures() const { return _sendFailures; }
+    uint32_t getDroppedRecords() const { return _droppedRecords; }
+
+private:
+    static const uint32_t RING_SIZE = 256; // ~4 min of 1 Hz samples buffered
+    static const uint8_t BATCH_SIZE = 30;  // Records per datagram (~1 KB)
+    static const uint8_t PROTOCOL_VERSION = 1;
+
+    // Flush a partial batch after this long so a quiet link still gets
+    // fresh data at a bounded age
+    static const uint32_t MAX_BATCH_AGE_MS = 60000;
+
+    // Reconnect/send backoff: doubles from 5 s to 5 min
+    static const uint32_t BACKOFF_MIN_MS = 5000;
+    static const uint32_t BACKOFF_MAX_MS = 300000;
+
+    struct __attribute__((packed)) PacketHeader
+    {
+        uint32_t magic; // 'VWT1'
+        uint16_t seq;
+        uint8_t count;
+        uint8_t version;
+    };
+    static const uint32_t PACKET_MAGIC = 0x31545756; // "VWT1" little-endian
+
+    const char *_ssid;
+    const char *_password;
+    const char *_host;
+    uint16_t _port;
+
+    // SPSC record ring: producer bumps _head, consumer bumps _tail
+    LogRecord _ring[RING_SIZE];
+    volatile uint32_t _head;
+    volatile uint32_t _tail;
+    uint32_t _droppedRecords;
+
+    WiFiUDP _udp;
+    uint16_t _seq;
+    uint32_t _sentBatches;
+    uint32_t _sendFailures;
+    uint32_t _backoffMs;
+    unsigned long _nextAttempt; // millis() gate for connect/send retries
+    unsigned long _lastSend;
+
+    static void taskEntry(void *arg);
+    void taskLoop();
+    void serviceLink();
+    bool sendBatch(uint8_t count);
+    uint32_t pending() const { return _head - _tail; }
+};
+
+#endif
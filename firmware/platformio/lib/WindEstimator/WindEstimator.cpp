@@ -0,0 +1,78 @@
+#include "WindEstimator.h"
+
+WindEstimator::WindEstimator()
+    : _rotorEstimate(0),
+      _rotorValid(false),
+      _anemometerHealthy(false),
+      _fused(0)
+{
+}
+
+float WindEstimator::update(float power, float rpm, float anemometerWind)
+{
+    // --- Rotor-derived estimate ------------------------------------
+    float tip = rpm * TurbineConfig::TIP_SPEED_PER_RPM; // ωR, m/s
+    bool sampleValid = (rpm >= MIN_RPM && power >= MIN_POWER_W);
+
+    if (sampleValid)
+    {
+        float g = power / (TurbineConfig::HALF_RHO_A * tip * tip * tip);
+
+        float lambda;
+        if (g >= windinv::INVERSE.gPeak)
+        {
+            // Above-peak g has no solution on this branch (deep stall or
+            // electrical transient): clamp to the peak
+            lambda = windinv::INVERSE.lambdaPeak;
+        }
+        else
+        {
+            float pos = (g / windinv::INVERSE.gPeak) * (windinv::InverseTable::SIZE - 1);
+            int idx = (int)pos;
+            float frac = pos - idx;
+            lambda = windinv::INVERSE.lambda[idx] +
+                     frac * (windinv::INVERSE.lambda[idx + 1] - windinv::INVERSE.lambda[idx]);
+        }
+
+        float v = tip / lambda;
+
+        if (_rotorValid)
+        {
+            // EMA smoothing against MPPT perturbation ripple
+            _rotorEstimate += EMA_ALPHA * (v - _rotorEstimate);
+        }
+        else
+        {
+            _rotorEstimate = v; // First valid sample seeds the filter
+            _rotorValid = true;
+        }
+    }
+    else
+    {
+        _rotorValid = false;
+    }
+
+    // --- Fusion with the anemometer --------------------------------
+    _anemometerHealthy =
+        (anemometerWind >= ANEMO_MIN_MS && anemometerWind <= ANEMO_MAX_MS);
+
+    if (_anemometerHealthy && _rotorValid)
+    {
+        _fused = ANEMO_WEIGHT * anemometerWind +
+                 (1.0f - ANEMO_WEIGHT) * _rotorEstimate;
+    }
+    else if (_rotorValid)
+    {
+        _fused = _rotorEstimate; // Anemometer failed: rotor carries on
+    }
+    else if (_anemometerHealthy)
+    {
+        _fused = anemometerWind; // Rotor parked: anemometer only
+    }
+    else
+    {
+        _fused = 0.0f; // Calm or both sources out
+    }
+
+    return _fused;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file WindEstimator.h
+ * @brief Sensorless wind speed from rotor dynamics, fused with the anemometer
+ *
+ * The rotor itself is the best anemometer on the machine: it sits in the
+ * actual inflow and has no mounting offset or cup inertia. From the
+ * power model
+ *     P = ½ρA·Cp(λ)·v³  with  λ = ωR/v
+ * substituting v = ωR/λ gives
+ *     g(λ) = Cp(λ)/λ³ = P / (½ρA·(ωR)³)
+ * so measured P and RPM pin down g, and inverting g on its decreasing
+ * branch yields λ, hence v = ωR/λ. The inverse is a compile-time lookup
+ * table built from the same constexpr Cp-λ table the MPPT feedforward
+ * uses - the estimate costs one divide, one table read and one
+ * interpolation per tick, no sensor I/O.
+ *
+ * The estimate is fused with the anemometer when its reading is
+ * plausible; when the anemometer fails (stuck near zero, open input) the
+ * estimator carries the machine alone instead of parking it in STANDBY.
+ */
+
+#ifndef WIND_ESTIMATOR_H
+#define WIND_ESTIMATOR_H
+
+#include <Arduino.h>
+#include "TurbineConfig.h"
+#include "CpLambdaTable.h"
+
+namespace windinv {
+
+/**
+ * Inverse of g(λ) = Cp(λ)/λ³ on the branch above g's peak, where g is
+ * strictly decreasing (λ ≈ 1.3 up to 4.0 for the Gaussian Cp model).
+ * Uniform grid in g/g_peak; entry i holds the λ where g crosses
+ * (i/(SIZE−1))·g_peak. Below-peak operation (deep stall) cannot be
+ * distinguished by this model and clamps to the peak.
+ */
+struct InverseTable {
+    static constexpr int SIZE = 129;
+
+    float lambda[SIZE];
+    float gPeak;      // max of Cp(λ)/λ³ over the operating band
+    float lambdaPeak; // λ at that peak
+
+    constexpr InverseTable() : lambda(), gPeak(0), lambdaPeak(0) {
+        // Locate the peak of g on a fine λ grid
+        constexpr float STEP = 0.005f;
+        for (float l = 0.5f; l <= 4.0f; l += STEP) {
+            float g = cplambda::cpAt(l) / (l * l * l);
+            if (g > gPeak) {
+                gPeak = g;
+                lambdaPeak = l;
+            }
+        }
+
+        // For each g level, walk the decreasing branch to the crossing
+        // and interpolate. i = SIZE−1 is the peak itself; i = 0 (g → 0)
+        // pins to the band edge.
+        lambda[SIZE - 1] = lambdaPeak;
+        for (int i = 0; i < SIZE - 1; i++) {
+            float target = gPeak * i / (SIZE - 1);
+            float result = 4.0f;
+            float prevL = lambdaPeak;
+            float prevG = gPeak;
+            for (float l = lambdaPeak; l <= 4.0f; l += STEP) {
+                float g = cplambda::cpAt(l) / (l * l * l);
+                if (g <= target) {
+                    float frac = (prevG - target) / (prevG - g);
+                    result = prevL + frac * (l - prevL);
+                    break;
+                }
+                prevL = l;
+                prevG = g;
+            }
+            lambda[i] = result;
+        }
+    }
+};
+
+inline constexpr InverseTable INVERSE{};
+
+} // namespace windinv
+
+class WindEstimator
+{
+public:
+    WindEstimator();
+
+    /**
+     * Update the estimate. Call every control tick.
+     * @param power Measured electrical power (W)
+     * @param rpm Measured rotor speed
+     * @param anemometerWind Latest anemometer reading (m/s)
+     * @return Fused wind speed (m/s)
+     */
+    float update(float power, float rpm, float anemometerWind);
+
+    /** Latest fused wind speed (m/s) */
+    float latest() const { return _fused; }
+
+    /** Latest rotor-derived estimate, 0 when invalid */
+    float rotorEstimate() const { return _rotorValid ? _rotorEstimate : 0.0f; }
+
+    /** True while the rotor estimate is usable (rotor turning, P > 0) */
+    bool rotorEstimateValid() const { return _rotorValid; }
+
+    /** True while the anemometer reading passes the plausibility check */
+    bool anemometerHealthy() const { return _anemometerHealthy; }
+
+private:
+    // Below these the model is numerically meaningless (g blows up /
+    // the generator is unloaded)
+    static constexpr float MIN_RPM = 10.0f;
+    static constexpr float MIN_POWER_W = 2.0f;
+
+    // Plausibility window for the anemometer: a dead ADC or detached cup
+    // reads ~0, a shorted input rails high
+    static constexpr float ANEMO_MIN_MS = 0.3f;
+    static constexpr float ANEMO_MAX_MS = 40.0f;
+
+    // Fusion weight on the anemometer when both sources are valid. The
+    // rotor estimate leads by up to a tick but carries P&O duty ripple;
+    // the anemometer is smooth but lagged.
+    static constexpr float ANEMO_WEIGHT = 0.6f;
+
+    // Light EMA on the rotor estimate to tame MPPT perturbation ripple
+    // (τ ≈ 0.5 s at the 100 Hz tick)
+    static constexpr float EMA_ALPHA = 0.02f;
+
+    float _rotorEstimate; // EMA-smoothed, m/s
+    bool _rotorValid;
+    bool _anemometerHealthy;
+    float _fused;
+};
+
+#endif
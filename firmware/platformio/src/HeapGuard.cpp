@@ -0,0 +1,62 @@
+/*
+ * Heap guard for the control task (see include/HeapGuard.h).
+ *
+ * Only compiled to anything in the esp32dev_heapcheck env, which links
+ * with --wrap so every direct malloc/calloc/realloc call site in the
+ * firmware and its libraries lands here first. The check is per-task, so
+ * legitimate allocations on core 0 (WiFi, SD, I/O task) pass through
+ * untouched and cannot false-positive the assertion.
+ */
+
+#ifdef VAWT_ASSERT_NO_HEAP
+
+#include "HeapGuard.h"
+
+static volatile TaskHandle_t guardedTask = NULL;
+
+void heapGuardArm(TaskHandle_t task)
+{
+    guardedTask = task;
+}
+
+static void heapGuardCheck(const char *what)
+{
+    if (guardedTask == NULL || xPortInIsrContext())
+    {
+        return;
+    }
+    if (xTaskGetCurrentTaskHandle() == guardedTask)
+    {
+        // abort() rather than log-and-continue: the whole point is to
+        // make the regression impossible to miss in bench testing
+        ets_printf("[HEAPGUARD] %s on the control task - aborting\n", what);
+        abort();
+    }
+}
+
+extern "C"
+{
+    void *__real_malloc(size_t size);
+    void *__real_calloc(size_t n, size_t size);
+    void *__real_realloc(void *ptr, size_t size);
+
+    void *__wrap_malloc(size_t size)
+    {
+        heapGuardCheck("malloc");
+        return __real_malloc(size);
+    }
+
+    void *__wrap_calloc(size_t n, size_t size)
+    {
+        heapGuardCheck("calloc");
+        return __real_calloc(n, size);
+    }
+
+    void *__wrap_realloc(void *ptr, size_t size)
+    {
+        heapGuardCheck("realloc");
+        return __real_realloc(ptr, size);
+    }
+}
+
+#endif // VAWT_ASSERT_NO_HEAP
@@ -0,0 +1,190 @@
+/*
+ * VAWT Control System - On-target microbenchmark suite
+ *
+ * Separate firmware image (pio run -e esp32dev_bench) sharing the lib/
+ * code with the production build. Runs each hot-path function in a tight
+ * loop against the CPU cycle counter and prints min/median/p99 cycles
+ * (and microseconds at 240 MHz) over serial, plus raw SD write
+ * throughput. These numbers are the regression baseline for every
+ * performance change - run before and after, diff the table.
+ *
+ * Covered hot paths:
+ *   MPPTController::update          - MPPT perturbation step
+ *   SafetyMonitor::check            - fast safety compares
+ *   calculateLambda/Cp equivalents  - aero helper math
+ *   DataLogger::log (CSV + binary)  - per-sample logging cost
+ *   INA219 voltage+current read     - blocking I2C acquisition
+ *   SD sequential write             - MB/s through DataLogger's path
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <SD.h>
+#include <SPI.h>
+#include <Adafruit_INA219.h>
+
+#include "TurbineConfig.h"
+#include "TurbineStateMachine.h"
+#include "MPPTController.h"
+#include "SafetyMonitor.h"
+#include "DataLogger.h"
+
+#define SD_CS_PIN 5
+
+static const int BENCH_ITERATIONS = 1000;
+static uint32_t cycleSamples[BENCH_ITERATIONS];
+
+Adafruit_INA219 ina219;
+MPPTController mppt(TurbineConfig::LAMBDA_OPT);
+SafetyMonitor safety(TurbineConfig::OVERSPEED_RPM, 60.0);
+DataLogger csvLogger;
+DataLogger binLogger;
+
+static bool sdAvailable = false;
+static bool inaAvailable = false;
+
+// Sink to stop the compiler folding benchmarked expressions away
+static volatile float sink;
+
+static int compareU32(const void *a, const void *b)
+{
+    uint32_t va = *(const uint32_t *)a;
+    uint32_t vb = *(const uint32_t *)b;
+    return (va > vb) - (va < vb);
+}
+
+static void report(const char *name, int iterations)
+{
+    qsort(cycleSamples, iterations, sizeof(uint32_t), compareU32);
+    uint32_t minC = cycleSamples[0];
+    uint32_t medC = cycleSamples[iterations / 2];
+    uint32_t p99C = cycleSamples[(iterations * 99) / 100];
+
+    // 240 MHz core clock: cycles / 240 = microseconds
+    Serial.printf("%-28s min %8lu  med %8lu  p99 %8lu cyc  (med %.2f us)\n",
+                  name, (unsigned long)minC, (unsigned long)medC,
+                  (unsigned long)p99C, medC / 240.0);
+}
+
+// Benchmark harness: times one call per iteration with the cycle counter
+template <typename F>
+static void bench(const char *name, F fn, int iterations = BENCH_ITERATIONS)
+{
+    for (int i = 0; i < iterations; i++)
+    {
+        uint32_t start = ESP.getCycleCount();
+        fn(i);
+        cycleSamples[i] = ESP.getCycleCount() - start;
+    }
+    report(name, iterations);
+}
+
+static void benchSdThroughput()
+{
+    if (!sdAvailable)
+    {
+        Serial.println("SD throughput: skipped (no card)");
+        return;
+    }
+
+    static uint8_t block[4096];
+    memset(block, 0xA5, sizeof(block));
+
+    File f = SD.open("/bench_throughput.bin", FILE_WRITE);
+    if (!f)
+    {
+        Serial.println("SD throughput: open failed");
+        return;
+    }
+
+    const size_t totalBytes = 256 * 1024;
+    unsigned long start = millis();
+    for (size_t written = 0; written < totalBytes; written += sizeof(block))
+    {
+        f.write(block, sizeof(block));
+    }
+    f.flush();
+    unsigned long elapsed = millis() - start;
+    f.close();
+    SD.remove("/bench_throughput.bin");
+
+    Serial.printf("SD sequential write: %u KB in %lu ms = %.2f MB/s\n",
+                  (unsigned)(totalBytes / 1024), elapsed,
+                  (totalBytes / 1048576.0) / (elapsed / 1000.0));
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    delay(2000);
+    Serial.println("\n=== VAWT Hot-Path Microbenchmarks ===");
+    Serial.printf("Core clock: %lu MHz | build " VAWT_VERSION "\n",
+                  (unsigned long)ESP.getCpuFreqMHz());
+
+    Wire.begin();
+    inaAvailable = ina219.begin();
+    if (!inaAvailable)
+    {
+        Serial.println("INA219 not found - I2C benchmarks skipped");
+    }
+
+    sdAvailable = csvLogger.begin(SD_CS_PIN, LOG_FORMAT_CSV);
+    if (sdAvailable)
+    {
+        binLogger.begin(SD_CS_PIN, LOG_FORMAT_BINARY);
+    }
+    else
+    {
+        Serial.println("SD not found - logger runs RAM-buffer only");
+    }
+
+    Serial.println();
+
+    // --- Controller math --------------------------------------------
+    bench("MPPTController::update", [](int i) {
+        mppt.pushWindSample(7.0f + (i % 10) * 0.1f);
+        sink = mppt.update(150.0f + (i % 20), 7.0f + (i % 10) * 0.1f);
+    });
+
+    bench("SafetyMonitor::check", [](int i) {
+        sink = safety.check(180.0f + (i % 50), 48.0f, 3.0f) ? 1.0f : 0.0f;
+    });
+
+    bench("lambda + Cp helpers", [](int i) {
+        float wind = 6.0f + (i % 10) * 0.2f;
+        float lambda = (200.0f * TurbineConfig::TIP_SPEED_PER_RPM) / wind;
+        float cp = 150.0f / (TurbineConfig::HALF_RHO_A * wind * wind * wind);
+        sink = lambda + cp;
+    });
+
+    // --- Logging ----------------------------------------------------
+    bench("DataLogger::log (CSV)", [](int i) {
+        csvLogger.log(i, STATE_MPPT, 7.5f, 200.0f, 48.0f, 3.1f,
+                      150.0f, 2.0f, 0.35f);
+    });
+    csvLogger.flush();
+
+    bench("DataLogger::log (binary)", [](int i) {
+        binLogger.log(i, STATE_MPPT, 7.5f, 200.0f, 48.0f, 3.1f,
+                      150.0f, 2.0f, 0.35f);
+    });
+    binLogger.flush();
+
+    // --- I2C acquisition --------------------------------------------
+    if (inaAvailable)
+    {
+        bench("INA219 V+I read pair", [](int i) {
+            sink = ina219.getBusVoltage_V() + ina219.getCurrent_mA();
+        }, 200);
+    }
+
+    // --- SD ---------------------------------------------------------
+    benchSdThroughput();
+
+    Serial.println("\n=== Benchmarks complete ===");
+}
+
+void loop()
+{
+    delay(10000);
+}
@@ -1,6 +1,15 @@
 /*
  * VAWT Control System - Main Loop
  * ESP32-DevKitC compatible
+ *
+ * Task layout (dual-core):
+ *   Core 1: controlTask - sensors, safety, state machine, MPPT, PWM.
+ *           Hard real-time; never touches SD, Serial or WiFi.
+ *   Core 0: ioTask - DataLogger, Serial debug output, NTP/WiFi.
+ *           Best-effort; an SD write stall here cannot delay a safety check.
+ * The control task hands finished samples to the I/O task through a
+ * FreeRTOS queue; if the queue is full the sample is dropped (logging is
+ * lossy by design, control is not).
  */
 
 #include <Arduino.h>
@@ -9,63 +18,178 @@
 #include <SPI.h>
 #include <WiFi.h>
 #include <time.h>
+#include <esp_timer.h>
+#include <esp_task_wdt.h>
+#include "TurbineConfig.h"
 #include "TurbineStateMachine.h"
 #include "MPPTController.h"
+#include "MPPTCheckpoint.h"
+#include "GustDetector.h"
 #include "SafetyMonitor.h"
+#include "PowerRegulator.h"
 #include "DataLogger.h"
-#include <Adafruit_INA219.h>
-Adafruit_INA219 ina219;
+#include "TachometerInput.h"
+#include "AnemometerInput.h"
+#include "WindEstimator.h"
+#include "LoopProfiler.h"
+#include "PowerSense.h"
+#include "TelemetryClient.h"
+#include "FleetLink.h"
+#include "BlackBox.h"
+#include "HeapGuard.h"
+
+// Fleet mode: build one unit per site with -DVAWT_FLEET_GATEWAY (owns
+// the WiFi/MQTT uplink) and the rest with -DVAWT_FLEET_MEMBER (ESP-NOW
+// only, no WiFi association). Neither flag = standalone unit.
+#if defined(VAWT_FLEET_MEMBER) || defined(VAWT_FLEET_GATEWAY)
+#define VAWT_FLEET_ENABLED 1
+#endif
 
 // Pin definitions
 #define RPM_SENSOR_PIN 34
 #define DUMP_LOAD_PWM_PIN 25
 #define BRAKE_RELAY_PIN 26
 #define SD_CS_PIN 5
-#define WIND_SPEED_PIN 35 // Analog input for anemometer
-
-// Turbine configuration (500W Helical Gorlov VAWT)
-const float ROTOR_RADIUS = 0.6;
-const float ROTOR_HEIGHT = 1.5;
-const float SWEPT_AREA = 1.8;
-const float LAMBDA_OPT = 2.0;
-const float CP_MAX = 0.35;
-const float RATED_POWER = 500.0;
-const float RATED_RPM = 180.0;
-const float OVERSPEED_RPM = 250.0;
+#define WIND_SPEED_PIN 35                    // Analog input for anemometer
+#define WIND_SPEED_ADC_CHANNEL ADC1_CHANNEL_7 // GPIO35 on ADC1
+
+// Turbine configuration: all rotor parameters come from TurbineConfig.h
+// (selected per model via -DVAWT_MODEL_* in platformio.ini). Shorthand
+// for the constants used throughout this file:
+const float RATED_POWER = TurbineConfig::RATED_POWER;
+const float RATED_RPM = TurbineConfig::RATED_RPM;
+const uint8_t RPM_PULSES_PER_REV = 1; // One hall pulse per revolution
+
+// Wind thresholds feeding the state machine events
+const float WIND_CUT_IN_MS = 3.0;  // STANDBY -> MPPT
+const float WIND_STALL_MS = 12.0;  // High-wind stall protection
+const float WIND_GUST_PREARM_MS = 9.0; // Floor for the predictive gust stall
+
+// Telemetry endpoint - override per site with -D in platformio.ini
+#ifndef TELEMETRY_WIFI_SSID
+#define TELEMETRY_WIFI_SSID "vawt-site"
+#endif
+#ifndef TELEMETRY_WIFI_PASS
+#define TELEMETRY_WIFI_PASS "changeme"
+#endif
+#ifndef TELEMETRY_HOST
+#define TELEMETRY_HOST "192.168.4.1" // Site gateway (UDP -> MQTT bridge)
+#endif
+#ifndef TELEMETRY_PORT
+#define TELEMETRY_PORT 9100
+#endif
+
+// Task configuration
+#define CONTROL_TASK_CORE 1
+#define IO_TASK_CORE 0
+#define CONTROL_TASK_STACK 4096
+#define IO_TASK_STACK 8192
+#define CONTROL_TASK_PRIORITY 10 // Above everything on core 1
+#define IO_TASK_PRIORITY 2       // Below WiFi/lwIP housekeeping on core 0
+#define SAMPLE_QUEUE_LENGTH 16
+
+// Scheduler rates. A hardware esp_timer ticks the control task at
+// TICK_RATE_HZ; each concern runs on its own divider so rates are exact
+// regardless of how long any one stage takes:
+//   safety        every tick   (100 Hz)
+//   tachometer    every tick   (PCNT read; the call rate sets the
+//                               pulse-period resolution)
+//   state machine every 2      (50 Hz)
+//   MPPT          every 10     (10 Hz - the rate MPPTController.h documents)
+//   logging       every LOG_DIVIDER (1 Hz default, configurable)
+#define TICK_RATE_HZ 100
+#define TICK_PERIOD_US (1000000 / TICK_RATE_HZ)
+#define STATE_MACHINE_DIVIDER 2
+#define MPPT_DIVIDER 10
+#define MPPT_DT_S ((float)MPPT_DIVIDER / TICK_RATE_HZ) // 0.1 s between duty updates
+#define LOG_DIVIDER 100
+#define GUST_SCAN_DIVIDER 100 // Spectral gust scan (1 Hz over a 10 s window)
+#define PROFILE_EMIT_DIVIDER 6000 // Per-stage timing stats every 60 s
+
+// Hardware watchdog: if the control task (the safety fast path) stops
+// ticking for this long, panic-reset into a safe state. The brake relay
+// is wired fail-safe, so a reset is a braked rotor.
+#define SAFETY_WDT_TIMEOUT_S 2
+
+// One completed control-loop sample, handed from core 1 to core 0
+struct SensorSample
+{
+    unsigned long timestamp;
+    TurbineState state;
+    float windSpeed;
+    float rpm;
+    float voltage;
+    float current;
+    float power;
+    float lambda;
+    float cp;
+};
 
 // Global objects
 TurbineStateMachine stateMachine;
-MPPTController mppt(LAMBDA_OPT);
-SafetyMonitor safety(OVERSPEED_RPM, 60.0);
+MPPTController mppt(TurbineConfig::LAMBDA_OPT);
+GustDetector gustDetector;
+SafetyMonitor safety(TurbineConfig::OVERSPEED_RPM, 60.0);
+PowerRegulator powerRegulator(TurbineConfig::RATED_POWER);
 DataLogger dataLogger;
-
-// ISR variables for RPM
-volatile unsigned long lastPulseTime = 0;
-volatile unsigned long pulsePeriod = 0;
+TachometerInput tachometer;
+AnemometerInput anemometer;
+WindEstimator windEstimator;
+PowerSense powerSense;
+TelemetryClient telemetry;
+BlackBox blackBox;
+#ifdef VAWT_FLEET_ENABLED
+FleetLink fleet;
+#endif
+
+QueueHandle_t sampleQueue = NULL;
+TaskHandle_t controlTaskHandle = NULL;
+TaskHandle_t ioTaskHandle = NULL;
+esp_timer_handle_t controlTickTimer = NULL;
+
+// Ticks the control task missed because a stage overran its slot
+volatile uint32_t controlOverruns = 0;
+
+// Wall-clock sync handoff: the I/O task stamps these once SNTP lands;
+// the control task (the log producer) then emits the epoch<->millis
+// marker itself, keeping the logger single-producer. Records carry
+// monotonic millis() timestamps, so one marker back-corrects the whole
+// boot's worth of log to wall time offline.
+volatile time_t wallClockEpoch = 0;
+volatile uint32_t wallClockMillis = 0;
+
+// Per-stage cycle statistics for the control tick
+LoopProfiler loopProfiler;
+
+// Snapshot of the latest profile report, handed to the I/O task for
+// serial output (producer writes, sets the flag; consumer prints, clears)
+char profileReport[LoopProfiler::STAGE_COUNT * 160];
+volatile uint32_t profileReportReady = 0;
 
 // Forward declarations
-void IRAM_ATTR rpmISR();
+void controlTick(void *arg);
+void controlTask(void *pvParameters);
+void ioTask(void *pvParameters);
 float readWindSpeed();
-float calculateRPM();
-float readBusVoltage();
-float readBusCurrent();
 float calculateLambda(float rpm, float windSpeed);
 float calculateCp(float power, float windSpeed);
 void engageDumpLoad();
 void engageBrake();
-float calculateSoftStall(float power, float rpm);
-
-void IRAM_ATTR rpmISR()
-{
-    unsigned long now = micros();
-    pulsePeriod = now - lastPulseTime;
-    lastPulseTime = now;
-}
 
+// Staged startup. After a brownout in storm winds the rotor freewheels
+// until the safety check runs, so everything on the path to a ticking
+// control task must be fast: GPIO, PWM, the sensor front-ends (PCNT,
+// ADC-DMA, one I2C config write) and an NVS read - a few tens of ms
+// total. Everything slow (SD mount, radio bring-up, SNTP) happens
+// afterwards on the I/O task while the rotor is already supervised;
+// records logged meanwhile buffer in RAM and timestamps are
+// back-corrected once wall time is known.
 void setup()
 {
+    // No startup delay: a USB-serial host that attaches late misses the
+    // banner, which is the right trade against a second of unsupervised
+    // rotor
     Serial.begin(115200);
-    delay(1000);
     Serial.println("\n=== VAWT Control System Starting ===");
 
     // Initialize GPIO
@@ -74,182 +198,574 @@ void setup()
     pinMode(BRAKE_RELAY_PIN, OUTPUT);
     pinMode(WIND_SPEED_PIN, INPUT);
 
-    configTime(19800, 0, "pool.ntp.org"); // UTC+5:30 = 19800 seconds
-
     // Setup PWM
     ledcSetup(0, 20000, 8); // 20kHz, 8-bit
     ledcAttachPin(DUMP_LOAD_PWM_PIN, 0);
 
-    // Attach RPM interrupt
-    attachInterrupt(digitalPinToInterrupt(RPM_SENSOR_PIN), rpmISR, FALLING);
+    // Start hardware pulse counting for RPM (PCNT unit, no ISR needed)
+    if (!tachometer.begin(RPM_SENSOR_PIN, RPM_PULSES_PER_REV))
+    {
+        Serial.println("WARNING: Tachometer PCNT init failed");
+    }
 
-    // Initialize I2C
+    // Start continuous DMA sampling of the anemometer
+    if (!anemometer.begin(WIND_SPEED_ADC_CHANNEL))
+    {
+        Serial.println("WARNING: Anemometer DMA sampling init failed");
+    }
+
+    // Initialize I2C and start asynchronous INA219 acquisition
     Wire.begin();
 
-    if (!ina219.begin())
+    if (!powerSense.begin())
     {
         Serial.println("Failed to find INA219 chip");
     }
 
-    // Initialize SD card
-    if (!dataLogger.begin(SD_CS_PIN))
+    // TSR feedforward seeded from the Cp-λ table, HCS refining around it
+    mppt.setMode(MPPT_MODE_HYBRID);
+
+    // Resume the MPPT search from the NVS checkpoint after a brownout or
+    // watchdog reset; falls back to a cold reset() when none is usable.
+    // NVS read, single-digit ms - stays ahead of the control task.
+    if (MPPTCheckpoint::restoreOrReset(mppt))
     {
-        Serial.println("WARNING: SD Card not available, continuing without logging");
+        Serial.println("MPPT resumed from checkpoint");
     }
 
-    Serial.println("Initialization complete.");
     stateMachine.setState(STATE_STANDBY);
+
+    // Create the sample queue and the two pinned tasks.
+    // Control goes on core 1 (free of the Arduino/WiFi stack), I/O on core 0.
+    sampleQueue = xQueueCreate(SAMPLE_QUEUE_LENGTH, sizeof(SensorSample));
+
+    xTaskCreatePinnedToCore(controlTask, "control", CONTROL_TASK_STACK,
+                            NULL, CONTROL_TASK_PRIORITY,
+                            &controlTaskHandle, CONTROL_TASK_CORE);
+    xTaskCreatePinnedToCore(ioTask, "io", IO_TASK_STACK,
+                            NULL, IO_TASK_PRIORITY,
+                            &ioTaskHandle, IO_TASK_CORE);
+
+    // Hardware timer drives the control task at a fixed tick rate -
+    // deterministic, independent of how long the loop body took
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = controlTick;
+    timerArgs.name = "ctrl_tick";
+    esp_timer_create(&timerArgs, &controlTickTimer);
+    esp_timer_start_periodic(controlTickTimer, TICK_PERIOD_US);
+
+    // Tie the safety fast path to the hardware task watchdog: a stalled
+    // control task means unsupervised rotor, so force a panic reset
+    esp_task_wdt_init(SAFETY_WDT_TIMEOUT_S, true);
+    esp_task_wdt_add(controlTaskHandle);
+
+    // Time-to-control metric: everything above this line is the boot
+    // budget; SD/radio/SNTP come up behind it on the I/O task
+    Serial.printf("[BOOT] control armed at %lu ms\n", millis());
 }
 
 void loop()
 {
-    static unsigned long lastSampleTime = 0;
-    unsigned long now = millis();
+    // All work happens in controlTask/ioTask; the Arduino loop task
+    // (core 1) is parked so it cannot interfere with the control task.
+    vTaskDelay(portMAX_DELAY);
+}
+
+// Timer callback (esp_timer task context): wake the control task. The
+// notification value accumulates if the task falls behind, which is how
+// overruns are detected.
+void controlTick(void *arg)
+{
+    if (controlTaskHandle != NULL)
+    {
+        xTaskNotifyGive(controlTaskHandle);
+    }
+}
+
+// === Control task (core 1) - hard real-time ===
+// Woken by the hardware timer at TICK_RATE_HZ; each concern runs on its
+// own divider. Must never block on SD, Serial or the network: the only
+// outbound path is a non-blocking queue send to the I/O task.
+void controlTask(void *pvParameters)
+{
+    uint32_t tick = 0;
+
+    // From here on this task must never touch the heap; the
+    // esp32dev_heapcheck build aborts loudly if it does
+    heapGuardArm(xTaskGetCurrentTaskHandle());
+
+    // Latest sensor values, shared across the rate groups
+    float windSpeed = 0, rpm = 0, voltage = 0, current = 0, power = 0;
+    float lambda = 0, cp = 0;
+
+    // Last commanded duty and previous state, for bumpless handover into
+    // the power regulator
+    float lastDuty = 0.3;
+    TurbineState previousState = STATE_IDLE;
+    bool lastSafe = true;
 
-    // 1 Hz sampling
-    if (now - lastSampleTime >= 1000)
+    for (;;)
     {
-        lastSampleTime = now;
-
-        // Read sensors
-        float windSpeed = readWindSpeed();
-        float rpm = calculateRPM();
-        float voltage = readBusVoltage();
-        float current = readBusCurrent();
-        float power = voltage * current;
-
-        // Compute derived quantities
-        float lambda = calculateLambda(rpm, windSpeed);
-        float cp = calculateCp(power, windSpeed);
-
-        // Safety checks
-        bool safe = safety.check(rpm, voltage, current);
-        if (!safe)
+        // Each pending notification is one timer tick; more than one
+        // means a stage overran its slot and ticks were missed
+        uint32_t pending = ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+        if (pending > 1)
         {
-            stateMachine.setState(STATE_FAULT);
-            engageBrake();
+            controlOverruns += pending - 1;
         }
+        tick++;
+        esp_task_wdt_reset(); // Prove the safety fast path is alive
 
-        // State machine logic
-        TurbineState currentState = stateMachine.getState();
+        // --- Every tick (100 Hz): cheap sensor refresh + safety ------
+        {
+            ScopedStageTimer timer(loopProfiler, LoopProfiler::STAGE_SENSORS);
+            tachometer.update(); // PCNT read; period since last pulses
+            rpm = tachometer.getRPM();
+
+            // Fuse the anemometer (non-blocking, DMA-sampled) with the
+            // rotor-derived estimate: the rotor feels a gust up to a
+            // tick before the cups report it, and carries the machine
+            // through anemometer failures. Uses last tick's power, 10 ms
+            // stale at worst.
+            windSpeed = windEstimator.update(power, rpm, readWindSpeed());
+
+            // Feed the wind window at 10 Hz in every state: the gust
+            // detector scans this window, and a window fed only from
+            // mppt.update() would freeze in POWER_REGULATION - stale
+            // gust scores latching while real gusts go unseen
+            if (tick % MPPT_DIVIDER == 0)
+            {
+                mppt.pushWindSample(windSpeed);
+            }
+        }
 
-        switch (currentState)
+        bool safe;
         {
-        case STATE_STANDBY:
-            if (windSpeed > 3.0 && safe)
+            ScopedStageTimer timer(loopProfiler, LoopProfiler::STAGE_SAFETY);
+            safe = safety.check(rpm, voltage, current);
+            if (!safe)
             {
-                stateMachine.setState(STATE_MPPT);
+                // Brake immediately (hardware action stays on the fast
+                // path); the transition itself goes through the table
+                engageBrake();
+                if (lastSafe)
+                {
+                    // Rising edge of the violation only: a persistent
+                    // trip re-fires this branch at 100 Hz, and a
+                    // level trigger would freeze-dump-rearm the black
+                    // box in a loop
+                    blackBox.trigger(); // Freeze the 30 s pre-trip capture
+                }
+                TurbineContext faultCtx;
+                faultCtx.windSpeed = windSpeed;
+                faultCtx.rpm = rpm;
+                faultCtx.power = power;
+                faultCtx.safe = false;
+                stateMachine.postEvent(EVENT_FAULT, faultCtx);
             }
-            break;
+            lastSafe = safe;
+        }
 
-        case STATE_MPPT:
+        // --- 1 Hz: spectral gust scan over the MPPT wind window ------
+        // Same task that owns the window, so the copy needs no locking;
+        // 5 Goertzel bins x 100 samples is a few microseconds
+        if (tick % GUST_SCAN_DIVIDER == 0)
         {
-            float dutyCycle = mppt.update(power, windSpeed);
-            ledcWrite(0, dutyCycle * 255);
+            gustDetector.update(mppt);
+        }
 
+        // --- 50 Hz: bus measurements + state machine -----------------
+        if (tick % STATE_MACHINE_DIVIDER == 0)
+        {
+            ScopedStageTimer timer(loopProfiler, LoopProfiler::STAGE_STATE_MACHINE);
+            // Coherent V/I pair from the async sampler - lock-free copy,
+            // no I2C on the control path
+            PowerReading reading = powerSense.latest();
+            voltage = reading.voltage;
+            current = reading.current;
+            power = reading.power;
+            lambda = calculateLambda(rpm, windSpeed);
+            cp = calculateCp(power, windSpeed);
+
+            // Sensor observations become events; which of them matter in
+            // the current state is the transition table's call - one
+            // array lookup per post, no growing switch on the decision
+            // path (see lib/StateMachine)
+            TurbineContext ctx;
+            ctx.windSpeed = windSpeed;
+            ctx.rpm = rpm;
+            ctx.power = power;
+            ctx.safe = safe;
+
+            if (windSpeed > WIND_CUT_IN_MS)
+            {
+                stateMachine.postEvent(EVENT_WIND_ABOVE_CUTIN, ctx);
+            }
+            if (windSpeed > WIND_STALL_MS)
+            {
+                stateMachine.postEvent(EVENT_HIGH_WIND, ctx);
+            }
+            // Predictive stall: rising low-frequency spectral energy
+            // precedes the raw threshold crossing by 1-2 s. Floored at
+            // WIND_GUST_PREARM_MS so spectral noise in light air cannot
+            // stall a producing rotor.
+            if (windSpeed > WIND_GUST_PREARM_MS && gustDetector.gustOnset())
+            {
+                stateMachine.postEvent(EVENT_GUST_PREDICTED, ctx);
+            }
             if (power > RATED_POWER * 0.95)
             {
-                stateMachine.setState(STATE_POWER_REGULATION);
+                stateMachine.postEvent(EVENT_RATED_POWER, ctx);
             }
-            if (windSpeed > 12.0)
+            if (power < RATED_POWER * 0.8)
             {
-                stateMachine.setState(STATE_STALL);
+                stateMachine.postEvent(EVENT_POWER_DROPPED, ctx);
             }
-        }
-        break;
+            if (rpm < RATED_RPM)
+            {
+                stateMachine.postEvent(EVENT_ROTOR_SLOWED, ctx);
+            }
+#ifdef VAWT_FLEET_ENABLED
+            // A neighbor's gust-induced STALL reaches us over ESP-NOW
+            // milliseconds before the gust convects downstream: pre-arm
+            // by treating it as our own high-wind observation
+            if (fleet.peerGustWarningActive())
+            {
+                stateMachine.postEvent(EVENT_HIGH_WIND, ctx);
+            }
+#endif
 
-        case STATE_POWER_REGULATION:
-        {
-            float softStallDuty = calculateSoftStall(power, rpm);
-            ledcWrite(0, softStallDuty * 255);
+            TurbineState activeState = stateMachine.getState();
 
-            if (power < RATED_POWER * 0.8)
+            // Bumpless handover: entering POWER_REGULATION seeds the
+            // regulator with the duty the MPPT was commanding, so the
+            // transition holds the operating point instead of jumping
+            if (activeState == STATE_POWER_REGULATION &&
+                previousState != STATE_POWER_REGULATION)
+            {
+                powerRegulator.arm(lastDuty);
+            }
+#ifdef VAWT_FLEET_ENABLED
+            // Our own STALL entry is the downstream rotors' early
+            // warning (flag only; the frame leaves on the I/O task)
+            if (activeState == STATE_STALL && previousState != STATE_STALL)
             {
-                stateMachine.setState(STATE_MPPT);
+                fleet.signalGustWarning(windSpeed);
             }
+#endif
+            // FAULT entries not driven by a safety trip (future fault
+            // sources) freeze the black box too; trigger() is idempotent
+            // when the safety path already fired it this event
+            if (activeState == STATE_FAULT && previousState != STATE_FAULT)
+            {
+                blackBox.trigger();
+            }
+            previousState = activeState;
+
+            // Per-state outputs. The pins belong here, not in the
+            // transition table.
+            switch (activeState)
+            {
+            case STATE_MPPT:
+                // Perturb at the rate the MPPT design assumes (10 Hz)
+                if (tick % MPPT_DIVIDER == 0)
+                {
+                    float dutyCycle = mppt.update(power, windSpeed, rpm);
+                    ledcWrite(0, dutyCycle * 255);
+                    lastDuty = dutyCycle;
+                }
+                break;
+
+            case STATE_POWER_REGULATION:
+                if (tick % MPPT_DIVIDER == 0)
+                {
+                    float regDuty = powerRegulator.update(power, MPPT_DT_S);
+                    ledcWrite(0, regDuty * 255);
+                    lastDuty = regDuty;
+                }
+                break;
+
+            case STATE_STALL:
+                engageDumpLoad();
+                break;
+
+            case STATE_FAULT:
+                engageBrake();
+                ledcWrite(0, 0);
+                break;
+
+            case STATE_STANDBY:
+            case STATE_IDLE:
+            case STATE_STARTUP:
+                // No outputs; STARTUP and IDLE are still unimplemented
+                break;
+            }
+
+            // Black-box capture, after the output stage so the record
+            // holds this tick's commanded duty. One quantized 17-byte
+            // store into the always-on pre-trigger ring.
+            blackBox.capture(millis(), (uint8_t)activeState, windSpeed,
+                             rpm, voltage, current, power, lastDuty);
         }
-        break;
 
-        case STATE_STALL:
-            engageDumpLoad();
-            if (rpm < RATED_RPM)
+        // --- Logging rate (1 Hz default) -----------------------------
+        if (tick % LOG_DIVIDER == 0)
+        {
+            unsigned long now = millis();
+            TurbineState currentState = stateMachine.getState();
+
+            // One-shot wall-time marker, logged by the producer task so
+            // the logger stays single-producer. Analysis maps every
+            // millis() timestamp in this boot to wall time from it.
+            static bool timeMarkerLogged = false;
+            if (!timeMarkerLogged && wallClockEpoch != 0)
             {
-                stateMachine.setState(STATE_STANDBY);
+                timeMarkerLogged = true;
+                char marker[56];
+                snprintf(marker, sizeof(marker), "#TIME epoch=%ld millis=%lu\n",
+                         (long)wallClockEpoch, (unsigned long)wallClockMillis);
+                dataLogger.logRaw(marker);
             }
-            break;
 
-        case STATE_FAULT:
-            engageBrake();
-            ledcWrite(0, 0);
-            break;
+            {
+                // Log directly from the control path: DataLogger::log()
+                // only appends to its RAM double buffer (bounded time, no
+                // SD access); the I/O task drains it via service().
+                ScopedStageTimer timer(loopProfiler, LoopProfiler::STAGE_LOGGING);
+                dataLogger.log(now, currentState, windSpeed, rpm,
+                               voltage, current, power, lambda, cp);
+            }
 
-        case STATE_IDLE:
-        case STATE_STARTUP:
-            // Not implemented in this basic version
-            break;
+            // Offer the same packed record the binary log formats use to
+            // the telemetry ring (lock-free; drops and counts when the
+            // uplink has fallen a full ring behind)
+            LogRecord record;
+            record.timestamp = now;
+            record.state = (uint8_t)currentState;
+            record.windSpeed = windSpeed;
+            record.rpm = rpm;
+            record.voltage = voltage;
+            record.current = current;
+            record.power = power;
+            record.lambda = lambda;
+            record.cp = cp;
+            telemetry.offer(record);
+
+#ifdef VAWT_FLEET_ENABLED
+            // Refresh the status snapshot the fleet link broadcasts
+            uint8_t faultFlags = (safety.isOverspeed() ? 0x01 : 0) |
+                                 (safety.isOvervoltage() ? 0x02 : 0) |
+                                 (safety.isOvercurrent() ? 0x04 : 0);
+            fleet.setStatus((uint8_t)currentState, faultFlags,
+                            power, rpm, windSpeed);
+#endif
+
+            // Hand the sample to the I/O task for debug output. Zero
+            // timeout: if the queue is full (stall on core 0) we drop it
+            // rather than wait.
+            SensorSample sample;
+            sample.timestamp = now;
+            sample.state = currentState;
+            sample.windSpeed = windSpeed;
+            sample.rpm = rpm;
+            sample.voltage = voltage;
+            sample.current = current;
+            sample.power = power;
+            sample.lambda = lambda;
+            sample.cp = cp;
+            xQueueSend(sampleQueue, &sample, 0);
         }
 
-        // Data logging
-        dataLogger.log(now, currentState, windSpeed, rpm,
-                       voltage, current, power, lambda, cp);
-
-        // Debug output
-        Serial.printf("State: %s | λ=%.2f | Cp=%.2f | P=%.1fW | RPM=%.0f\n",
-                      stateMachine.getStateName(), lambda, cp, power, rpm);
+        // --- Periodic per-stage timing report ------------------------
+        if (tick % PROFILE_EMIT_DIVIDER == 0)
+        {
+            unsigned long now = millis();
+            size_t pos = 0;
+            for (int s = 0; s < LoopProfiler::STAGE_COUNT; s++)
+            {
+                char line[160];
+                loopProfiler.formatStage((LoopProfiler::Stage)s, now,
+                                         line, sizeof(line));
+                dataLogger.logRaw(line); // Lands next to the turbine data
+
+                if (pos + strlen(line) < sizeof(profileReport))
+                {
+                    strcpy(profileReport + pos, line);
+                    pos += strlen(line);
+                }
+            }
+            loopProfiler.reset();
+            profileReportReady = 1; // I/O task echoes it to Serial
+        }
     }
+}
 
-    // Background tasks
-    if (now % 10000 == 0)
+// === I/O task (core 0) - best effort ===
+// Drains sealed DataLogger buffers to the SD card and prints debug
+// output. May block on the card; the control task is unaffected.
+void ioTask(void *pvParameters)
+{
+    // --- Deferred bring-up -------------------------------------------
+    // Runs once, after the control task is already supervising the
+    // rotor. log() only appends to the RAM double buffer, so records
+    // produced during the SD mount are drained normally once it is up.
+    if (!dataLogger.begin(SD_CS_PIN))
+    {
+        Serial.println("WARNING: SD Card not available, continuing without logging");
+    }
+    Serial.printf("[BOOT] storage ready at %lu ms\n", millis());
+
+#ifdef VAWT_FLEET_ENABLED
+    // Site fleet over ESP-NOW: status broadcast + peer gust warnings
+#ifdef VAWT_FLEET_GATEWAY
+    if (!fleet.begin(FleetLink::FLEET_GATEWAY))
+#else
+    if (!fleet.begin(FleetLink::FLEET_MEMBER))
+#endif
     {
-        dataLogger.flush();
+        Serial.println("WARNING: Fleet link init failed");
     }
+#endif
+
+#ifndef VAWT_FLEET_MEMBER
+    // Batched binary uplink to the site gateway (core-0 task; the link
+    // comes and goes on its own schedule, records always still hit SD).
+    // Fleet members skip this: the gateway unit owns the site's single
+    // WiFi association and uplink.
+    if (!telemetry.begin(TELEMETRY_WIFI_SSID, TELEMETRY_WIFI_PASS,
+                         TELEMETRY_HOST, TELEMETRY_PORT))
+    {
+        Serial.println("WARNING: Telemetry task failed to start");
+    }
+#endif
 
-    delay(10);
-}
+    // Async SNTP (UTC+5:30 = 19800 s); sync lands in the background
+    // whenever the WiFi association does, detected in the loop below
+    configTime(19800, 0, "pool.ntp.org");
 
-// === Sensor Reading Functions ===
+    unsigned long lastFlushTime = millis();
+    unsigned long lastCheckpointTime = millis();
+    SensorSample sample;
 
-float readWindSpeed()
-{
-    // Analog anemometer: 0-5V = 0-25 m/s
-    int raw = analogRead(WIND_SPEED_PIN);
-    float voltage = (raw / 4095.0) * 3.3; // ESP32 ADC is 0-3.3V
-    return voltage * (25.0 / 3.3);        // Scale to wind speed
-}
+    for (;;)
+    {
+        // Block until a sample arrives (or 1 s, so draining still happens
+        // if the control task ever stops producing)
+        if (xQueueReceive(sampleQueue, &sample, pdMS_TO_TICKS(1000)) == pdTRUE)
+        {
+            // Debug output
+            Serial.printf("State: %s | λ=%.2f | Cp=%.2f | P=%.1fW | RPM=%.0f | ovr=%lu\n",
+                          stateMachine.getStateName(),
+                          sample.lambda, sample.cp, sample.power, sample.rpm,
+                          (unsigned long)controlOverruns);
+        }
 
-float calculateRPM()
-{
-    if (pulsePeriod == 0)
-        return 0;
-    unsigned long period = pulsePeriod;
-    float freq = 1000000.0 / period;
-    return freq * 60.0;
-}
+        // Report any safety events and state transitions queued by the
+        // fast path
+        safety.reportEvents();
+        stateMachine.reportTransitions();
 
-float readBusVoltage()
-{
-    return ina219.getBusVoltage_V();
+#ifdef VAWT_FLEET_ENABLED
+        // Fleet radio work: periodic status frame + any pending gust
+        // warning queued by the control task
+        fleet.service();
+#endif
+
+        // Echo the periodic per-stage timing report
+        if (profileReportReady)
+        {
+            Serial.print(profileReport);
+            profileReportReady = 0;
+        }
+
+        // First SNTP sync: publish the epoch<->millis pair for the
+        // control task's log marker. Threshold matches MPPTCheckpoint's
+        // clock-validity check.
+        if (wallClockEpoch == 0)
+        {
+            time_t nowEpoch = time(NULL);
+            if (nowEpoch > 1600000000)
+            {
+                wallClockMillis = millis(); // Stamp before publishing
+                wallClockEpoch = nowEpoch;
+                Serial.printf("[BOOT] wall clock synced at %lu ms (epoch %ld)\n",
+                              (unsigned long)wallClockMillis, (long)nowEpoch);
+            }
+        }
+
+        // Write any sealed log buffers to the card
+        dataLogger.service();
+
+        // Flush a frozen black-box ring to its dump file (no-op between
+        // fault events)
+        blackBox.service();
+
+        // Periodic flush every 10 s picks up the partially-filled buffer
+        unsigned long now = millis();
+        if (now - lastFlushTime >= 10000)
+        {
+            lastFlushTime = now;
+            dataLogger.flush();
+        }
+
+        // Checkpoint the MPPT search state to NVS so a brownout resumes
+        // near the operating point (NVS commit stays off the control core)
+        if (now - lastCheckpointTime >= MPPTCheckpoint::SAVE_INTERVAL_MS)
+        {
+            lastCheckpointTime = now;
+            MPPTCheckpoint::save(mppt);
+        }
+
+#ifdef VAWT_FLEET_GATEWAY
+        // Site summary for the uplink/operator console
+        static unsigned long lastFleetReport = 0;
+        if (now - lastFleetReport >= 30000)
+        {
+            lastFleetReport = now;
+            // Locked snapshot: the receive callback rewrites frames in
+            // the live table, so iterating it raw would tear a read
+            FleetLink::PeerStatus peers[FleetLink::MAX_PEERS];
+            int peerCount = fleet.copyPeers(peers);
+            float fleetPower = 0;
+            int faulted = 0;
+            for (int i = 0; i < peerCount; i++)
+            {
+                fleetPower += peers[i].frame.power;
+                if (peers[i].frame.state == (uint8_t)STATE_FAULT)
+                {
+                    faulted++;
+                }
+            }
+            Serial.printf("[FLEET] %d peers, %.0f W aggregate, %d faulted\n",
+                          peerCount, fleetPower, faulted);
+        }
+#endif
+    }
 }
 
-float readBusCurrent()
+// === Sensor Reading Functions ===
+
+float readWindSpeed()
 {
-    return ina219.getCurrent_mA() / 1000.0;
+    // Latest oversampled value from the DMA sampler - non-blocking,
+    // hundreds of raw ADC samples averaged per reading
+    return anemometer.latest();
 }
 
 float calculateLambda(float rpm, float windSpeed)
 {
     if (windSpeed < 0.5)
         return 0;
-    float omega = rpm * (2 * PI / 60.0);
-    return (omega * ROTOR_RADIUS) / windSpeed;
+    // 2π/60·R folded at compile time: one multiply, one divide
+    return (rpm * TurbineConfig::TIP_SPEED_PER_RPM) / windSpeed;
 }
 
 float calculateCp(float power, float windSpeed)
 {
     if (windSpeed < 0.5)
         return 0;
-    float rho = 1.15;
-    float windPower = 0.5 * rho * SWEPT_AREA * pow(windSpeed, 3);
+    // ½ρA folded at compile time; v³ as a multiply chain instead of pow()
+    float windPower = TurbineConfig::HALF_RHO_A * windSpeed * windSpeed * windSpeed;
     return power / windPower;
 }
 
@@ -264,13 +780,3 @@ void engageBrake()
     digitalWrite(BRAKE_RELAY_PIN, HIGH);
     ledcWrite(0, 0);
 }
-
-float calculateSoftStall(float power, float rpm)
-{
-    float targetPower = RATED_POWER;
-    float error = targetPower - power;
-    static float integrator = 0;
-    integrator += error * 0.001;
-    float duty = 0.5 + 0.01 * error + integrator;
-    return constrain(duty, 0.1, 0.9);
-}
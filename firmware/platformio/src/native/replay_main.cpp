@@ -0,0 +1,496 @@
+/*
+ * VAWT Control System - Native trace replay driver / yield regression
+ *
+ * Runs the real controller libraries (MPPTController,
+ * TurbineStateMachine, SafetyMonitor, PowerRegulator) on the host
+ * against a recorded wind/power trace, e.g.
+ * datasets/example-runs/sample-10min.csv. The Arduino API comes from
+ * hal/native/Arduino.h with a simulated clock, so a ten-minute field
+ * trace replays in well under a millisecond and parameter sweeps
+ * (k_turb, BASE_STEP_SIZE, state thresholds) run as batch jobs instead
+ * of field time.
+ *
+ * Beyond the summary it scores each run: harvested energy (power
+ * integrated over the producing states), post-gust convergence time and
+ * state-transition counts. With --baseline the metrics are checked
+ * against a checked-in reference (counts exact, floats within 2%), so
+ * any change to step sizing, thresholds or state logic gets an
+ * energy-yield delta in CI before it ships to the fleet. A deliberate
+ * behavior change regenerates the reference with --write-baseline.
+ *
+ * Usage:
+ *   pio run -e native && .pio/build/native/program <trace.csv> [repeats]
+ *       [--baseline <file>] [--write-baseline <file>]
+ *
+ * Trace columns (header skipped): the standard dataset layout
+ *   timestamp,state,wind_speed_ms,rotor_rpm,duty_cycle,voltage_dc,
+ *   current_dc,power_w,...
+ * Rows are assumed 1 s apart, matching the example datasets.
+ */
+
+#include <Arduino.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include "TurbineConfig.h"
+#include "TurbineStateMachine.h"
+#include "MPPTController.h"
+#include "SafetyMonitor.h"
+#include "PowerRegulator.h"
+
+struct TraceRow
+{
+    float windSpeed;
+    float rpm;
+    float voltage;
+    float current;
+};
+
+// One scored run. Counts must reproduce exactly between runs of the
+// same code; float metrics are compared with tolerance (compiler and
+// libm differences move the last bits, not the physics).
+struct RunMetrics
+{
+    unsigned long simSeconds;
+    unsigned long transitions;
+    unsigned long mpptSeconds;
+    unsigned long stallSeconds;
+    unsigned long faultSeconds;
+    unsigned long stallEpisodes;
+    unsigned long gustEpisodes;
+    double energyWh;       // Integrated over MPPT + POWER_REG seconds
+    double meanDuty;       // Mean commanded duty while producing
+    double gustConvMeanS;  // Mean gust-onset -> duty-resettled time
+};
+
+static bool loadTrace(const char *path, std::vector<TraceRow> &rows)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+    {
+        fprintf(stderr, "Cannot open trace: %s\n", path);
+        return false;
+    }
+
+    char line[512];
+    bool first = true;
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        if (first) // Header row
+        {
+            first = false;
+            continue;
+        }
+
+        // timestamp,state,wind_speed_ms,rotor_rpm,duty_cycle,voltage_dc,
+        // current_dc,power_w,...
+        TraceRow row;
+        char timestamp[64], state[32];
+        float duty;
+        int parsed = sscanf(line, "%63[^,],%31[^,],%f,%f,%f,%f,%f",
+                            timestamp, state, &row.windSpeed, &row.rpm,
+                            &duty, &row.voltage, &row.current);
+        if (parsed == 7)
+        {
+            rows.push_back(row);
+        }
+    }
+    fclose(f);
+    return !rows.empty();
+}
+
+// Replay the trace through the controller stack, mirroring the event
+// posting and per-state outputs of src/main.cpp at the trace's 1 Hz.
+static RunMetrics replay(const std::vector<TraceRow> &trace, int repeats)
+{
+    TurbineStateMachine stateMachine;
+    MPPTController mppt(TurbineConfig::LAMBDA_OPT);
+    SafetyMonitor safety(TurbineConfig::OVERSPEED_RPM, 60.0);
+    PowerRegulator powerRegulator(TurbineConfig::RATED_POWER);
+
+    stateMachine.setState(STATE_STANDBY);
+
+    RunMetrics m = {};
+    double dutySum = 0;
+    unsigned long dutySamples = 0;
+
+    float lastDuty = 0.3;
+    TurbineState previousState = STATE_STANDBY;
+
+    // Gust bookkeeping: onset = wind up >= 2 m/s over 3 s; converged
+    // when the machine is back in MPPT with the duty resettled near its
+    // pre-gust value (capped so a never-converging run still terminates)
+    const float GUST_RISE_MS = 2.0f;
+    const int GUST_RISE_WINDOW_S = 3;
+    const float DUTY_SETTLE_BAND = 0.05f;
+    const unsigned long GUST_CONV_CAP_S = 120;
+    bool gustActive = false;
+    float preGustDuty = 0;
+    float preGustWind = 0;
+    unsigned long gustElapsed = 0;
+    double gustConvSum = 0;
+
+    for (int pass = 0; pass < repeats; pass++)
+    {
+        for (size_t i = 0; i < trace.size(); i++)
+        {
+            const TraceRow &row = trace[i];
+            ArduinoShim::advanceMillis(1000); // 1 Hz trace
+
+            float power = row.voltage * row.current;
+
+            // As on target: the wind window is fed in every state, not
+            // just from mppt.update() while in MPPT
+            mppt.pushWindSample(row.windSpeed);
+
+            TurbineState before = stateMachine.getState();
+
+            bool safe = safety.check(row.rpm, row.voltage, row.current);
+
+            // Mirror the on-target event posting in src/main.cpp: the
+            // transition table in lib/StateMachine decides what fires
+            TurbineContext ctx;
+            ctx.windSpeed = row.windSpeed;
+            ctx.rpm = row.rpm;
+            ctx.power = power;
+            ctx.safe = safe;
+
+            if (!safe)
+            {
+                stateMachine.postEvent(EVENT_FAULT, ctx);
+            }
+            if (row.windSpeed > 3.0)
+            {
+                stateMachine.postEvent(EVENT_WIND_ABOVE_CUTIN, ctx);
+            }
+            if (row.windSpeed > 12.0)
+            {
+                stateMachine.postEvent(EVENT_HIGH_WIND, ctx);
+            }
+            if (power > TurbineConfig::RATED_POWER * 0.95)
+            {
+                stateMachine.postEvent(EVENT_RATED_POWER, ctx);
+            }
+            if (power < TurbineConfig::RATED_POWER * 0.8)
+            {
+                stateMachine.postEvent(EVENT_POWER_DROPPED, ctx);
+            }
+            if (row.rpm < TurbineConfig::RATED_RPM)
+            {
+                stateMachine.postEvent(EVENT_ROTOR_SLOWED, ctx);
+            }
+
+            TurbineState activeState = stateMachine.getState();
+
+            // Bumpless handover into the soft-stall regulator, as on
+            // target
+            if (activeState == STATE_POWER_REGULATION &&
+                previousState != STATE_POWER_REGULATION)
+            {
+                powerRegulator.arm(lastDuty);
+            }
+            if (activeState == STATE_STALL && previousState != STATE_STALL)
+            {
+                m.stallEpisodes++;
+            }
+            previousState = activeState;
+
+            if (activeState == STATE_MPPT)
+            {
+                lastDuty = mppt.update(power, row.windSpeed);
+                dutySum += lastDuty;
+                dutySamples++;
+            }
+            else if (activeState == STATE_POWER_REGULATION)
+            {
+                lastDuty = powerRegulator.update(power, 1.0f);
+                dutySum += lastDuty;
+                dutySamples++;
+            }
+
+            // Energy only counts while a producing state holds the load;
+            // seconds spent dumped (STALL) or braked (FAULT) are the cost
+            // the state logic pays for protection
+            if (activeState == STATE_MPPT ||
+                activeState == STATE_POWER_REGULATION)
+            {
+                m.energyWh += power / 3600.0;
+            }
+
+            // Gust scoring from the wind trace itself, independent of
+            // what the controller did with it
+            if (!gustActive && i >= (size_t)GUST_RISE_WINDOW_S &&
+                row.windSpeed - trace[i - GUST_RISE_WINDOW_S].windSpeed >=
+                    GUST_RISE_MS)
+            {
+                gustActive = true;
+                gustElapsed = 0;
+                preGustDuty = lastDuty;
+                preGustWind = trace[i - GUST_RISE_WINDOW_S].windSpeed;
+                m.gustEpisodes++;
+            }
+            else if (gustActive)
+            {
+                gustElapsed++;
+                bool settled = (activeState == STATE_MPPT &&
+                                row.windSpeed < preGustWind + 1.0f &&
+                                fabsf(lastDuty - preGustDuty) <=
+                                    DUTY_SETTLE_BAND);
+                if (settled || gustElapsed >= GUST_CONV_CAP_S)
+                {
+                    gustConvSum += gustElapsed;
+                    gustActive = false;
+                }
+            }
+
+            if (activeState != before)
+            {
+                m.transitions++;
+            }
+            if (activeState == STATE_MPPT)
+                m.mpptSeconds++;
+            if (activeState == STATE_STALL)
+                m.stallSeconds++;
+            if (activeState == STATE_FAULT)
+                m.faultSeconds++;
+            m.simSeconds++;
+        }
+    }
+
+    if (gustActive) // Trace ended mid-gust: charge what elapsed
+    {
+        gustConvSum += gustElapsed;
+    }
+    m.meanDuty = dutySamples > 0 ? dutySum / dutySamples : 0;
+    m.gustConvMeanS =
+        m.gustEpisodes > 0 ? gustConvSum / m.gustEpisodes : 0;
+    return m;
+}
+
+// --- Baseline comparison -------------------------------------------------
+
+struct MetricDef
+{
+    const char *name;
+    double value;
+    bool exact; // Counts compare exactly; floats within REL_TOLERANCE
+};
+
+static const double REL_TOLERANCE = 0.02;
+static const double ABS_FLOOR = 0.05; // For metrics that sit near zero
+
+static void collectMetrics(const RunMetrics &m, MetricDef out[], int *count)
+{
+    int n = 0;
+    out[n++] = {"sim_seconds", (double)m.simSeconds, true};
+    out[n++] = {"transitions", (double)m.transitions, true};
+    out[n++] = {"mppt_seconds", (double)m.mpptSeconds, true};
+    out[n++] = {"stall_seconds", (double)m.stallSeconds, true};
+    out[n++] = {"fault_seconds", (double)m.faultSeconds, true};
+    out[n++] = {"stall_episodes", (double)m.stallEpisodes, true};
+    out[n++] = {"gust_episodes", (double)m.gustEpisodes, true};
+    out[n++] = {"energy_wh", m.energyWh, false};
+    out[n++] = {"mean_duty", m.meanDuty, false};
+    out[n++] = {"gust_conv_mean_s", m.gustConvMeanS, false};
+    *count = n;
+}
+
+static bool writeBaseline(const char *path, const MetricDef metrics[],
+                          int count, const char *tracePath)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL)
+    {
+        fprintf(stderr, "Cannot write baseline: %s\n", path);
+        return false;
+    }
+    fprintf(f, "# Replay baseline for %s - regenerate with --write-baseline\n",
+            tracePath);
+    for (int i = 0; i < count; i++)
+    {
+        fprintf(f, "%s %.6f\n", metrics[i].name, metrics[i].value);
+    }
+    fclose(f);
+    printf("Baseline written: %s\n", path);
+    return true;
+}
+
+// Compare against the reference file. Returns the number of regressions;
+// a metric present in neither direction (added/removed) also fails, so
+// baselines stay in step with the harness.
+static int compareBaseline(const char *path, const MetricDef metrics[],
+                           int count)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+    {
+        fprintf(stderr, "Cannot open baseline: %s\n", path);
+        return 1;
+    }
+
+    bool seen[32] = {false};
+    int failures = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        if (line[0] == '#')
+            continue;
+        char name[64];
+        double expected;
+        if (sscanf(line, "%63s %lf", name, &expected) != 2)
+            continue;
+
+        int idx = -1;
+        for (int i = 0; i < count; i++)
+        {
+            if (strcmp(metrics[i].name, name) == 0)
+            {
+                idx = i;
+                break;
+            }
+        }
+        if (idx < 0)
+        {
+            printf("FAIL %-18s in baseline but not reported\n", name);
+            failures++;
+            continue;
+        }
+        seen[idx] = true;
+
+        double actual = metrics[idx].value;
+        bool ok;
+        if (metrics[idx].exact)
+        {
+            ok = (actual == expected);
+        }
+        else
+        {
+            double tol = fabs(expected) * REL_TOLERANCE;
+            if (tol < ABS_FLOOR)
+                tol = ABS_FLOOR;
+            ok = fabs(actual - expected) <= tol;
+        }
+
+        if (ok)
+        {
+            printf("ok   %-18s %.3f (baseline %.3f)\n", name, actual,
+                   expected);
+        }
+        else
+        {
+            printf("FAIL %-18s %.3f vs baseline %.3f\n", name, actual,
+                   expected);
+            failures++;
+        }
+    }
+    fclose(f);
+
+    for (int i = 0; i < count; i++)
+    {
+        if (!seen[i])
+        {
+            printf("FAIL %-18s reported but missing from baseline\n",
+                   metrics[i].name);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    const char *tracePath = NULL;
+    const char *baselinePath = NULL;
+    const char *writeBaselinePath = NULL;
+    int repeats = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+        {
+            baselinePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--write-baseline") == 0 && i + 1 < argc)
+        {
+            writeBaselinePath = argv[++i];
+        }
+        else if (tracePath == NULL)
+        {
+            tracePath = argv[i];
+        }
+        else
+        {
+            repeats = atoi(argv[i]);
+        }
+    }
+    if (tracePath == NULL)
+    {
+        fprintf(stderr,
+                "Usage: %s <trace.csv> [repeats] [--baseline <file>] "
+                "[--write-baseline <file>]\n",
+                argv[0]);
+        return 1;
+    }
+    if (repeats < 1)
+        repeats = 1;
+
+    std::vector<TraceRow> trace;
+    if (!loadTrace(tracePath, trace))
+    {
+        return 1;
+    }
+
+    // Silence per-transition serial output for batch throughput
+    Serial.enabled = false;
+
+    clock_t wallStart = clock();
+    RunMetrics m = replay(trace, repeats);
+    double wallSeconds = (double)(clock() - wallStart) / CLOCKS_PER_SEC;
+
+    printf("=== Replay summary ===\n");
+    printf("Trace rows:        %zu x %d passes = %lu simulated seconds\n",
+           trace.size(), repeats, m.simSeconds);
+    printf("Wall time:         %.3f s (%.0f sim-s per wall-s)\n",
+           wallSeconds, wallSeconds > 0 ? m.simSeconds / wallSeconds : 0.0);
+    printf("Harvested energy:  %.2f Wh over %lu producing seconds\n",
+           m.energyWh, m.mpptSeconds);
+    printf("State transitions: %lu (%lu stall episodes)\n",
+           m.transitions, m.stallEpisodes);
+    printf("Residency:         MPPT %lu s, STALL %lu s, FAULT %lu s\n",
+           m.mpptSeconds, m.stallSeconds, m.faultSeconds);
+    printf("Mean duty:         %.3f\n", m.meanDuty);
+    printf("Gusts:             %lu episodes, mean convergence %.1f s\n",
+           m.gustEpisodes, m.gustConvMeanS);
+
+    MetricDef metrics[32];
+    int metricCount = 0;
+    collectMetrics(m, metrics, &metricCount);
+
+    if (writeBaselinePath != NULL)
+    {
+        if (!writeBaseline(writeBaselinePath, metrics, metricCount,
+                           tracePath))
+        {
+            return 1;
+        }
+    }
+    if (baselinePath != NULL)
+    {
+        printf("=== Baseline check (%s) ===\n", baselinePath);
+        int failures = compareBaseline(baselinePath, metrics, metricCount);
+        if (failures > 0)
+        {
+            printf("%d metric(s) regressed - if the change is intentional, "
+                   "regenerate with --write-baseline\n",
+                   failures);
+            return 1;
+        }
+        printf("All metrics within tolerance\n");
+    }
+
+    return 0;
+}